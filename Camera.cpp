@@ -0,0 +1,150 @@
+#include "Camera.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const float MinZoom = 0.25f;     // Максимальное приближение
+    const float MaxZoom = 8.0f;      // Максимальное отдаление
+    const float ZoomStep = 1.1f;     // Шаг масштаба на одно деление колеса
+    const float PanSpeed = 1200.0f;  // Скорость перемещения с клавиатуры (пикселей экрана в секунду)
+}
+
+// Создать камеру с размером вида в пикселях над картой указанного размера в тайлах
+Camera::Camera(sf::Vector2f viewSize, int numTilesX, int numTilesY, int tileSize)
+    : m_view(viewSize * 0.5f, viewSize)
+    , m_baseSize(viewSize)
+    , m_zoom(1.0f)
+    , m_numTilesX(numTilesX)
+    , m_numTilesY(numTilesY)
+    , m_tileSize(tileSize)
+    , m_dragging(false)
+{
+    clampToWorld();
+}
+
+// Обработать событие окна (колесо мыши - масштаб, правая кнопка - перетаскивание, изменение размера окна)
+void Camera::handleEvent(const sf::Event& event, const sf::RenderWindow& window)
+{
+    switch (event.type)
+    {
+    case sf::Event::MouseWheelScrolled:
+        zoom(event.mouseWheelScroll.delta > 0 ? 1.0f / ZoomStep : ZoomStep);
+        break;
+
+    case sf::Event::MouseButtonPressed:
+        if (event.mouseButton.button == sf::Mouse::Right)
+        {
+            m_dragging = true;
+            m_lastMouse = sf::Vector2i(event.mouseButton.x, event.mouseButton.y);
+        }
+        break;
+
+    case sf::Event::MouseButtonReleased:
+        if (event.mouseButton.button == sf::Mouse::Right)
+            m_dragging = false;
+        break;
+
+    case sf::Event::MouseMoved:
+        if (m_dragging)
+        {
+            sf::Vector2i mouse(event.mouseMove.x, event.mouseMove.y);
+            sf::Vector2f from = window.mapPixelToCoords(m_lastMouse, m_view);
+            sf::Vector2f to = window.mapPixelToCoords(mouse, m_view);
+            move(from - to);
+            m_lastMouse = mouse;
+        }
+        break;
+
+    case sf::Event::Resized:
+        m_baseSize = sf::Vector2f(static_cast<float>(event.size.width), static_cast<float>(event.size.height));
+        m_view.setSize(m_baseSize * m_zoom);
+        clampToWorld();
+        break;
+
+    default:
+        break;
+    }
+}
+
+// Переместить камеру с клавиатуры (стрелки / WASD)
+void Camera::update(sf::Time elapsed)
+{
+    sf::Vector2f direction;
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left) || sf::Keyboard::isKeyPressed(sf::Keyboard::A))
+        direction.x -= 1;
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right) || sf::Keyboard::isKeyPressed(sf::Keyboard::D))
+        direction.x += 1;
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Up) || sf::Keyboard::isKeyPressed(sf::Keyboard::W))
+        direction.y -= 1;
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Down) || sf::Keyboard::isKeyPressed(sf::Keyboard::S))
+        direction.y += 1;
+
+    if (direction.x != 0 || direction.y != 0)
+    {
+        move(direction * (PanSpeed * m_zoom * elapsed.asSeconds()));
+    }
+}
+
+// Сдвинуть камеру на смещение в пикселях мира
+void Camera::move(sf::Vector2f offset)
+{
+    m_view.move(offset);
+    clampToWorld();
+}
+
+// Изменить масштаб (factor > 1 - отдалить)
+void Camera::zoom(float factor)
+{
+    m_zoom = std::max(MinZoom, std::min(m_zoom * factor, MaxZoom));
+    m_view.setSize(m_baseSize * m_zoom);
+    clampToWorld();
+}
+
+// Установить центр камеры в пикселях мира
+void Camera::setCenter(sf::Vector2f center)
+{
+    m_view.setCenter(center);
+    clampToWorld();
+}
+
+// Получить вид SFML
+const sf::View& Camera::getView() const
+{
+    return m_view;
+}
+
+// Получить прямоугольник видимых тайлов, обрезанный по границам карты
+sf::IntRect Camera::getVisibleTiles() const
+{
+    sf::Vector2f half = m_view.getSize() * 0.5f;
+    sf::Vector2f topLeft = m_view.getCenter() - half;
+    sf::Vector2f bottomRight = m_view.getCenter() + half;
+
+    int left = static_cast<int>(std::floor(topLeft.x / m_tileSize));
+    int top = std::max(0, static_cast<int>(std::floor(topLeft.y / m_tileSize)));
+    int right = static_cast<int>(std::ceil(bottomRight.x / m_tileSize));
+    if (m_numTilesX != UnboundedWidth)
+    {
+        left = std::max(0, left);
+        right = std::min(m_numTilesX, right);
+    }
+    int bottom = std::min(m_numTilesY, static_cast<int>(std::ceil(bottomRight.y / m_tileSize)));
+
+    return sf::IntRect(left, top, std::max(0, right - left), std::max(0, bottom - top));
+}
+
+// Не дать камере уйти за границы карты
+void Camera::clampToWorld()
+{
+    sf::Vector2f worldSize(static_cast<float>(m_numTilesX * m_tileSize), static_cast<float>(m_numTilesY * m_tileSize));
+    sf::Vector2f half = m_view.getSize() * 0.5f;
+    sf::Vector2f center = m_view.getCenter();
+
+    // Если вид больше карты, держать карту по центру (мир без ширины ограничивается только по высоте)
+    if (m_numTilesX != UnboundedWidth)
+        center.x = half.x * 2 >= worldSize.x ? worldSize.x * 0.5f : std::max(half.x, std::min(center.x, worldSize.x - half.x));
+    center.y = half.y * 2 >= worldSize.y ? worldSize.y * 0.5f : std::max(half.y, std::min(center.y, worldSize.y - half.y));
+    m_view.setCenter(center);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+// Класс камеры: перемещение и масштаб вида над картой, которая больше экрана
+class Camera
+{
+public:
+    static const int UnboundedWidth = 0; // Ширина карты для мира, не ограниченного по горизонтали
+
+    // Создать камеру с размером вида в пикселях над картой указанного размера в тайлах
+    Camera(sf::Vector2f viewSize, int numTilesX, int numTilesY, int tileSize);
+    // Обработать событие окна (колесо мыши - масштаб, правая кнопка - перетаскивание, изменение размера окна)
+    void handleEvent(const sf::Event& event, const sf::RenderWindow& window);
+    // Переместить камеру с клавиатуры (стрелки / WASD)
+    void update(sf::Time elapsed);
+    // Сдвинуть камеру на смещение в пикселях мира
+    void move(sf::Vector2f offset);
+    // Изменить масштаб (factor > 1 - отдалить)
+    void zoom(float factor);
+    // Установить центр камеры в пикселях мира
+    void setCenter(sf::Vector2f center);
+    // Получить вид SFML
+    const sf::View& getView() const;
+    // Получить прямоугольник видимых тайлов, обрезанный по границам карты (для UnboundedWidth - только по высоте)
+    sf::IntRect getVisibleTiles() const;
+
+private:
+    // Не дать камере уйти за границы карты
+    void clampToWorld();
+
+    sf::View m_view;            // Вид SFML
+    sf::Vector2f m_baseSize;    // Размер вида при масштабе 1
+    float m_zoom;               // Текущий масштаб
+    int m_numTilesX;            // Ширина карты в тайлах
+    int m_numTilesY;            // Высота карты в тайлах
+    int m_tileSize;             // Размер тайла
+    bool m_dragging;            // Камера перетаскивается мышью
+    sf::Vector2i m_lastMouse;   // Последняя позиция мыши при перетаскивании
+};
@@ -0,0 +1,188 @@
+#include "CaveGenerator.h"
+
+#include <algorithm>
+
+#include "Random.h"
+#include "TerrainGenerator.h"
+#include "World.h"
+
+namespace
+{
+    const int CaveMinDepth = 5; // Глубина под поверхностью, выше которой пещер нет
+    const int WordBits = 64;    // Клеток в слове битовой доски
+
+    // Битовая доска: клетка - бит (1 - стена), 64 клетки подряд по строке в одном слове.
+    // Бит i слова w строки - столбец originX + w * 64 + i. Вокруг доски лежит рамка из слов-стен
+    // (по слову слева и справа, по строке сверху и снизу), поэтому соседей читают без проверок границ
+    struct BitBoard
+    {
+        int wordsPerRow = 0;
+        int rows = 0;
+        std::vector<std::uint64_t> words;
+
+        BitBoard(int wordsPerRow, int rows)
+            : wordsPerRow(wordsPerRow)
+            , rows(rows)
+            , words(static_cast<std::size_t>(wordsPerRow + 2) * (rows + 2), ~0ull)
+        {
+        }
+
+        // Получить первое слово строки y (y от -1 до rows включительно - с рамкой)
+        std::uint64_t* row(int y) { return words.data() + static_cast<std::size_t>(y + 1) * (wordsPerRow + 2) + 1; }
+        const std::uint64_t* row(int y) const { return words.data() + static_cast<std::size_t>(y + 1) * (wordsPerRow + 2) + 1; }
+    };
+
+    // Полный сумматор разрядных плоскостей: 64 независимых сложения трёх битов за раз
+    inline void fullAdd(std::uint64_t a, std::uint64_t b, std::uint64_t c, std::uint64_t& sum, std::uint64_t& carry)
+    {
+        std::uint64_t ab = a ^ b;
+        sum = ab ^ c;
+        carry = (a & b) | (ab & c);
+    }
+
+    // Шаг автомата: клетка становится стеной при 5 и более соседях-стенах, остаётся стеной при 4.
+    // Клетки вне доски - стены; клетки fixed (вне камня) остаются стенами
+    void stepCaves(const BitBoard& current, const BitBoard& fixed, BitBoard& next)
+    {
+        for (int y = 0; y < current.rows; ++y)
+        {
+            const std::uint64_t* rows[3] = { current.row(y - 1), current.row(y), current.row(y + 1) };
+            const std::uint64_t* fixedRow = fixed.row(y);
+            std::uint64_t* out = next.row(y);
+
+            for (int w = 0; w < current.wordsPerRow; ++w)
+            {
+                // Восемь соседей - три строки, сдвинутые на клетку влево и вправо с переносом из соседних слов
+                std::uint64_t n[8];
+                int k = 0;
+                for (int r = 0; r < 3; ++r)
+                {
+                    std::uint64_t center = rows[r][w];
+                    n[k++] = (center << 1) | (rows[r][w - 1] >> (WordBits - 1));
+                    n[k++] = (center >> 1) | (rows[r][w + 1] << (WordBits - 1));
+                    if (r != 1)
+                        n[k++] = center;
+                }
+
+                // Сумма восьми соседей в разрядах count1 (1), count2 (2), count4 (4), count8 (8)
+                std::uint64_t s0, c0, s1, c1, count1, t;
+                fullAdd(n[0], n[1], n[2], s0, c0);
+                fullAdd(n[3], n[4], n[5], s1, c1);
+                std::uint64_t s2 = n[6] ^ n[7];
+                std::uint64_t c2 = n[6] & n[7];
+                fullAdd(s0, s1, s2, count1, t);
+                std::uint64_t u, v;
+                fullAdd(c0, c1, c2, u, v);
+                std::uint64_t count2 = u ^ t;
+                std::uint64_t w4 = u & t;
+                std::uint64_t count4 = v ^ w4;
+                std::uint64_t count8 = v & w4;
+
+                // >= 5: 8, или 4 вместе с 1 или 2; ровно 4: только разряд 4
+                std::uint64_t atLeast5 = count8 | (count4 & (count2 | count1));
+                std::uint64_t exactly4 = count4 & ~count8 & ~count2 & ~count1;
+                out[w] = atLeast5 | (rows[1][w] & exactly4) | fixedRow[w];
+            }
+        }
+    }
+}
+
+// Вырезать пещеры в камне участка region, лежащего в мире высотой worldHeight начиная с тайла (originX, originY)
+void generateCaves(TileGrid& region, int originX, int originY, int worldHeight,
+    const std::vector<int>& surface, int surfaceX, std::uint64_t worldSeed)
+{
+    if (region.getWidth() == 0 || region.getHeight() == 0)
+    {
+        return;
+    }
+
+    // Окно автомата: участок с запасом, по горизонтали выровненный на слово в координатах мира,
+    // чтобы случайные биты слова зависели только от его положения в мире
+    int windowX = floorDiv(originX - CaveMargin, WordBits) * WordBits;
+    int windowEnd = originX + region.getWidth() + CaveMargin;
+    int windowY = std::max(0, originY - CaveMargin);
+    int windowBottom = std::min(worldHeight, originY + region.getHeight() + CaveMargin);
+
+    const int wordsPerRow = (windowEnd - windowX + WordBits - 1) / WordBits;
+    const int rows = windowBottom - windowY;
+    BitBoard cells(wordsPerRow, rows);
+    BitBoard fixed(wordsPerRow, rows);
+    BitBoard next(wordsPerRow, rows);
+
+    // Клетки, где пещер не бывает: выше глубины CaveMinDepth под поверхностью и вне известных столбцов.
+    // Столбец открывается с некоторой строки и дальше открыт до низа, поэтому маска открытых клеток
+    // строится сверху вниз: в каждой строке добавляются биты столбцов, которые открываются в ней
+    std::vector<std::vector<int>> opening(rows);
+    for (int x = 0; x < wordsPerRow * WordBits; ++x)
+    {
+        int column = windowX + x - surfaceX;
+        if (column < 0 || column >= static_cast<int>(surface.size()))
+            continue;
+        int firstRow = std::max(0, surface[column] + CaveMinDepth - windowY);
+        if (firstRow < rows)
+            opening[firstRow].push_back(x);
+    }
+    std::vector<std::uint64_t> open(wordsPerRow, 0);
+    for (int y = 0; y < rows; ++y)
+    {
+        for (int x : opening[y])
+        {
+            open[x / WordBits] |= 1ull << (x % WordBits);
+        }
+        std::uint64_t* fixedRow = fixed.row(y);
+        for (int w = 0; w < wordsPerRow; ++w)
+        {
+            fixedRow[w] = ~open[w];
+        }
+    }
+
+    // Начальный шум: стена с вероятностью 9/16 (a | b & c & d по четырём случайным словам);
+    // после сглаживания пустоты занимают около четверти камня
+    const std::uint64_t caveSeed = deriveSeed(worldSeed, CaveStream);
+    for (int y = 0; y < rows; ++y)
+    {
+        std::uint64_t* row = cells.row(y);
+        const std::uint64_t* fixedRow = fixed.row(y);
+        for (int w = 0; w < wordsPerRow; ++w)
+        {
+            std::int64_t wordX = floorDiv(windowX, WordBits) + w;
+            RandomStream random(deriveSeed(deriveSeed(caveSeed, static_cast<std::uint64_t>(wordX)), static_cast<std::uint64_t>(windowY + y)));
+            std::uint64_t a = random.next();
+            std::uint64_t b = random.next();
+            std::uint64_t c = random.next();
+            std::uint64_t d = random.next();
+            row[w] = (a | (b & c & d)) | fixedRow[w];
+        }
+    }
+
+    for (int i = 0; i < CaveIterations; ++i)
+    {
+        stepCaves(cells, fixed, next);
+        cells.words.swap(next.words);
+    }
+
+    // Открытые клетки окна, попавшие в участок, становятся пустотой (там сейчас камень);
+    // слова из одних стен пропускаются целиком
+    for (int y = 0; y < region.getHeight(); ++y)
+    {
+        const std::uint64_t* row = cells.row(originY + y - windowY);
+        TileSpan<TileId> tiles = region.row(y);
+        for (int x = 0; x < region.getWidth();)
+        {
+            int bit = originX + x - windowX;
+            std::uint64_t walls = row[bit / WordBits] >> (bit % WordBits);
+            int count = std::min(WordBits - bit % WordBits, region.getWidth() - x);
+            if (walls == (~0ull >> (bit % WordBits)))
+            {
+                x += count;
+                continue;
+            }
+            for (int i = 0; i < count; ++i, walls >>= 1)
+            {
+                if (!(walls & 1) && tiles[x + i] == RockTile)
+                    tiles[x + i] = SkyTile; // Пустота пещеры - тот же тайл, что и небо
+            }
+            x += count;
+        }
+    }
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "TileGrid.h"
+
+const int CaveIterations = 4;          // Шаги сглаживания клеточного автомата
+const int CaveMargin = CaveIterations; // Запас клеток вокруг участка: на столько клеток за шаг распространяется влияние
+
+// Вырезать пещеры в камне участка region, лежащего в мире высотой worldHeight начиная с тайла (originX, originY).
+// Пещеры - результат сглаживающего клеточного автомата над случайным шумом; шум зависит только
+// от зерна мира и координат, а автомат считается с запасом CaveMargin вокруг участка, поэтому
+// соседние участки (чанки) стыкуются без швов. surface - высоты поверхности столбцов мира
+// [surfaceX, surfaceX + surface.size()): для бесшовных чанков они должны покрывать запас,
+// столбцы вне этого диапазона считаются сплошным камнем (край конечной карты)
+void generateCaves(TileGrid& region, int originX, int originY, int worldHeight,
+    const std::vector<int>& surface, int surfaceX, std::uint64_t worldSeed);
@@ -0,0 +1,286 @@
+#include "ChunkRenderer.h"
+
+#include <algorithm>
+
+static_assert(ChunkRenderer::ChunkSize == ZLevelMap::ChunkSize, "Z-level chunks must match rendered chunks");
+
+// Создать рендерер с типами тайлов из реестра
+ChunkRenderer::ChunkRenderer(int tileSize, const TileRegistry& tileRegistry)
+    : m_tileSize(tileSize)
+    , m_tileRegistry(tileRegistry)
+    , m_drawCalls(0)
+    , m_decoded(ChunkSize, ChunkSize)
+    , m_sourceKind(SourceKind::None)
+    , m_source(nullptr)
+    , m_level(-1)
+{
+}
+
+// Пометить тайл как изменённый (его чанк будет перестроен перед отрисовкой)
+void ChunkRenderer::invalidateTile(int x, int y)
+{
+    auto it = m_chunks.find(World::chunkKey(floorDiv(x, ChunkSize), floorDiv(y, ChunkSize)));
+    if (it != m_chunks.end())
+    {
+        it->second.dirty = true;
+    }
+}
+
+// Пометить как изменённые все чанки, пересекающие прямоугольник (в тайлах)
+void ChunkRenderer::invalidateRect(const sf::IntRect& tiles)
+{
+    if (tiles.width <= 0 || tiles.height <= 0)
+    {
+        return;
+    }
+
+    int firstX = floorDiv(tiles.left, ChunkSize);
+    int firstY = floorDiv(tiles.top, ChunkSize);
+    int lastX = floorDiv(tiles.left + tiles.width - 1, ChunkSize);
+    int lastY = floorDiv(tiles.top + tiles.height - 1, ChunkSize);
+    for (int chunkY = firstY; chunkY <= lastY; ++chunkY)
+    {
+        for (int chunkX = firstX; chunkX <= lastX; ++chunkX)
+        {
+            auto it = m_chunks.find(World::chunkKey(chunkX, chunkY));
+            if (it != m_chunks.end())
+                it->second.dirty = true;
+        }
+    }
+}
+
+// Пометить все чанки как изменённые
+void ChunkRenderer::invalidateAll()
+{
+    for (auto& chunk : m_chunks)
+    {
+        chunk.second.dirty = true;
+    }
+}
+
+// Нарисовать видимую часть карты (прямоугольник в тайлах), перестроив только изменённые чанки
+void ChunkRenderer::draw(sf::RenderTarget& target, const TileGrid& tileMap, const sf::IntRect& visibleTiles)
+{
+    m_drawCalls = 0;
+    selectSource(SourceKind::Grid, &tileMap, -1);
+    if (visibleTiles.width <= 0 || visibleTiles.height <= 0)
+    {
+        return;
+    }
+
+    // Диапазон чанков, пересекающих видимый прямоугольник
+    int numChunksX = (tileMap.getWidth() + ChunkSize - 1) / ChunkSize;
+    int numChunksY = (tileMap.getHeight() + ChunkSize - 1) / ChunkSize;
+    int firstX = std::max(0, floorDiv(visibleTiles.left, ChunkSize));
+    int firstY = std::max(0, floorDiv(visibleTiles.top, ChunkSize));
+    int lastX = std::min(numChunksX - 1, floorDiv(visibleTiles.left + visibleTiles.width - 1, ChunkSize));
+    int lastY = std::min(numChunksY - 1, floorDiv(visibleTiles.top + visibleTiles.height - 1, ChunkSize));
+
+    for (int chunkY = firstY; chunkY <= lastY; ++chunkY)
+    {
+        for (int chunkX = firstX; chunkX <= lastX; ++chunkX)
+        {
+            Chunk& chunk = m_chunks[World::chunkKey(chunkX, chunkY)];
+            if (chunk.dirty)
+            {
+                int startX = chunkX * ChunkSize;
+                int startY = chunkY * ChunkSize;
+                rebuildChunk(chunk, tileMap, startX, startY,
+                    std::min(ChunkSize, tileMap.getWidth() - startX), std::min(ChunkSize, tileMap.getHeight() - startY), startX, startY);
+            }
+            drawChunk(target, chunk);
+        }
+    }
+
+    releaseHiddenChunks(firstX, firstY, lastX, lastY);
+}
+
+// Нарисовать видимую часть мира; ещё не сгенерированные чанки пропускаются
+// и рисуются, когда появятся в мире (генерацию ведёт вызывающий)
+void ChunkRenderer::draw(sf::RenderTarget& target, const World& world, const sf::IntRect& visibleTiles)
+{
+    m_drawCalls = 0;
+    selectSource(SourceKind::World, &world, -1);
+    if (visibleTiles.width <= 0 || visibleTiles.height <= 0)
+    {
+        return;
+    }
+
+    // По горизонтали мир не ограничен, по вертикали - его высотой
+    int firstX = floorDiv(visibleTiles.left, ChunkSize);
+    int firstY = std::max(0, floorDiv(visibleTiles.top, ChunkSize));
+    int lastX = floorDiv(visibleTiles.left + visibleTiles.width - 1, ChunkSize);
+    int lastY = std::min(world.getChunkCountY() - 1, floorDiv(visibleTiles.top + visibleTiles.height - 1, ChunkSize));
+
+    for (int chunkY = firstY; chunkY <= lastY; ++chunkY)
+    {
+        for (int chunkX = firstX; chunkX <= lastX; ++chunkX)
+        {
+            Chunk& chunk = m_chunks[World::chunkKey(chunkX, chunkY)];
+            if (chunk.dirty)
+            {
+                const PackedChunk* tiles = world.findChunk(chunkX, chunkY);
+                if (!tiles)
+                    continue;
+
+                // Чанк мира сжат палитрой: строки распаковываются целиком во временную карту
+                for (int y = 0; y < tiles->getHeight(); ++y)
+                {
+                    tiles->decodeRow(y, m_decoded.row(y).data());
+                }
+                rebuildChunk(chunk, m_decoded, 0, 0, tiles->getWidth(), tiles->getHeight(), chunkX * ChunkSize, chunkY * ChunkSize);
+            }
+            drawChunk(target, chunk);
+        }
+    }
+
+    releaseHiddenChunks(firstX, firstY, lastX, lastY);
+}
+
+// Нарисовать видимую часть уровня z трёхмерной карты; при смене уровня все чанки перестраиваются
+void ChunkRenderer::draw(sf::RenderTarget& target, const ZLevelMap& levels, int z, const sf::IntRect& visibleTiles)
+{
+    m_drawCalls = 0;
+    selectSource(SourceKind::Levels, &levels, z);
+    if (visibleTiles.width <= 0 || visibleTiles.height <= 0)
+    {
+        return;
+    }
+
+    int firstX = std::max(0, floorDiv(visibleTiles.left, ChunkSize));
+    int firstY = std::max(0, floorDiv(visibleTiles.top, ChunkSize));
+    int lastX = std::min(levels.getChunkCountX() - 1, floorDiv(visibleTiles.left + visibleTiles.width - 1, ChunkSize));
+    int lastY = std::min(levels.getChunkCountY() - 1, floorDiv(visibleTiles.top + visibleTiles.height - 1, ChunkSize));
+
+    for (int chunkY = firstY; chunkY <= lastY; ++chunkY)
+    {
+        for (int chunkX = firstX; chunkX <= lastX; ++chunkX)
+        {
+            Chunk& chunk = m_chunks[World::chunkKey(chunkX, chunkY)];
+            if (chunk.dirty)
+            {
+                // Невыделенный чанк уровня целиком состоит из заполнителя уровня
+                int width = levels.getChunkWidth(chunkX);
+                int height = levels.getChunkHeight(chunkY);
+                const PackedChunk* tiles = levels.findChunk(chunkX, chunkY, z);
+                for (int y = 0; y < height; ++y)
+                {
+                    TileId* row = m_decoded.row(y).data();
+                    if (tiles)
+                        tiles->decodeRow(y, row);
+                    else
+                        std::fill(row, row + width, levels.getLevelFill(z));
+                }
+                rebuildChunk(chunk, m_decoded, 0, 0, width, height, chunkX * ChunkSize, chunkY * ChunkSize);
+            }
+            drawChunk(target, chunk);
+        }
+    }
+
+    releaseHiddenChunks(firstX, firstY, lastX, lastY);
+}
+
+// Получить количество вызовов draw за последнюю отрисовку
+int ChunkRenderer::getDrawCalls() const
+{
+    return m_drawCalls;
+}
+
+// Запомнить карту, которую рисует draw: чанки других карт с теми же координатами выбрасываются,
+// а при смене уровня той же ZLevelMap - перестраиваются
+void ChunkRenderer::selectSource(SourceKind kind, const void* source, int level)
+{
+    if (kind != m_sourceKind || source != m_source)
+    {
+        m_chunks.clear();
+        m_sourceKind = kind;
+        m_source = source;
+    }
+    else if (level != m_level)
+    {
+        invalidateAll();
+    }
+    m_level = level;
+}
+
+// Перестроить вершины чанка по участку source [sourceX, sourceX + width) x [sourceY, sourceY + height),
+// который лежит в мире начиная с тайла (worldX, worldY)
+void ChunkRenderer::rebuildChunk(Chunk& chunk, const TileGrid& source, int sourceX, int sourceY, int width, int height, int worldX, int worldY)
+{
+    chunk.layers.clear();
+
+    float size = static_cast<float>(m_tileSize);
+
+    for (int y = 0; y < height; ++y)
+    {
+        TileSpan<const TileId> row = source.row(sourceY + y);
+        for (int x = 0; x < width; ++x)
+        {
+            const TileType& tileType = m_tileRegistry[row[sourceX + x]];
+            const sf::Texture* texture = tileType.texture;
+            if (!texture)
+                continue;
+
+            // Найти слой с текстурой тайла (в чанке обычно всего несколько текстур)
+            Layer* layer = nullptr;
+            for (auto& candidate : chunk.layers)
+            {
+                if (candidate.texture == texture)
+                {
+                    layer = &candidate;
+                    break;
+                }
+            }
+            if (!layer)
+            {
+                chunk.layers.push_back(Layer{ texture, sf::VertexArray(sf::Quads) });
+                layer = &chunk.layers.back();
+            }
+
+            float left = (worldX + x) * size;
+            float top = (worldY + y) * size;
+            float u0 = static_cast<float>(tileType.rect.left);
+            float v0 = static_cast<float>(tileType.rect.top);
+            float u1 = u0 + tileType.rect.width;
+            float v1 = v0 + tileType.rect.height;
+            layer->vertices.append(sf::Vertex(sf::Vector2f(left, top), tileType.color, sf::Vector2f(u0, v0)));
+            layer->vertices.append(sf::Vertex(sf::Vector2f(left + size, top), tileType.color, sf::Vector2f(u1, v0)));
+            layer->vertices.append(sf::Vertex(sf::Vector2f(left + size, top + size), tileType.color, sf::Vector2f(u1, v1)));
+            layer->vertices.append(sf::Vertex(sf::Vector2f(left, top + size), tileType.color, sf::Vector2f(u0, v1)));
+        }
+    }
+
+    chunk.dirty = false;
+}
+
+// Нарисовать слои чанка
+void ChunkRenderer::drawChunk(sf::RenderTarget& target, const Chunk& chunk)
+{
+    for (const auto& layer : chunk.layers)
+    {
+        target.draw(layer.vertices, sf::RenderStates(layer.texture));
+        ++m_drawCalls;
+    }
+}
+
+// Освободить вершины невидимых чанков, если их накопилось слишком много
+void ChunkRenderer::releaseHiddenChunks(int firstX, int firstY, int lastX, int lastY)
+{
+    // Держать в памяти не меньше нескольких экранов чанков, чтобы не перестраивать их при каждом шаге камеры
+    int visibleCount = (lastX - firstX + 1) * (lastY - firstY + 1);
+    std::size_t limit = static_cast<std::size_t>(std::max(MinResidentChunks, visibleCount * 4));
+    if (m_chunks.size() <= limit)
+    {
+        return;
+    }
+
+    for (auto it = m_chunks.begin(); it != m_chunks.end();)
+    {
+        int chunkX = static_cast<int>(static_cast<std::uint32_t>(it->first >> 32));
+        int chunkY = static_cast<int>(static_cast<std::uint32_t>(it->first));
+        if (chunkX >= firstX && chunkX <= lastX && chunkY >= firstY && chunkY <= lastY)
+            ++it;
+        else
+            it = m_chunks.erase(it);
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "TileGrid.h"
+#include "TileRegistry.h"
+#include "World.h"
+#include "ZLevelMap.h"
+
+// Класс для отрисовки карты тайлов чанками (один VertexArray на текстуру в чанке).
+// Чанки хранятся по координатам, поэтому карта может быть и конечной (TileGrid), и неограниченной (World),
+// и одним уровнем трёхмерной карты (ZLevelMap)
+class ChunkRenderer
+{
+public:
+    static const int ChunkSize = World::ChunkSize; // Размер чанка в тайлах (совпадает с чанком мира)
+    static const int MinResidentChunks = 256;      // Минимальное число чанков с построенными вершинами
+
+    // Создать рендерер с типами тайлов из реестра
+    ChunkRenderer(int tileSize, const TileRegistry& tileRegistry);
+    // Пометить тайл как изменённый (его чанк будет перестроен перед отрисовкой)
+    void invalidateTile(int x, int y);
+    // Пометить как изменённые все чанки, пересекающие прямоугольник (в тайлах)
+    void invalidateRect(const sf::IntRect& tiles);
+    // Пометить все чанки как изменённые
+    void invalidateAll();
+    // Нарисовать видимую часть карты (прямоугольник в тайлах), перестроив только изменённые чанки
+    // (если до этого рисовалась другая карта, все чанки строятся заново)
+    void draw(sf::RenderTarget& target, const TileGrid& tileMap, const sf::IntRect& visibleTiles);
+    // Нарисовать видимую часть мира; ещё не сгенерированные чанки пропускаются
+    // и рисуются, когда появятся в мире (генерацию ведёт вызывающий)
+    void draw(sf::RenderTarget& target, const World& world, const sf::IntRect& visibleTiles);
+    // Нарисовать видимую часть уровня z трёхмерной карты; при смене уровня все чанки перестраиваются
+    void draw(sf::RenderTarget& target, const ZLevelMap& levels, int z, const sf::IntRect& visibleTiles);
+    // Получить количество вызовов draw за последнюю отрисовку
+    int getDrawCalls() const;
+
+private:
+    // Слой чанка: все тайлы одной текстуры (при общем атласе слой один)
+    struct Layer
+    {
+        const sf::Texture* texture;
+        sf::VertexArray vertices;
+    };
+
+    // Вид карты, по которой построены вершины чанков
+    enum class SourceKind
+    {
+        None,   // Вершины ещё не строились
+        Grid,   // TileGrid
+        World,  // World
+        Levels  // Уровень ZLevelMap
+    };
+
+    // Чанк: закешированные слои и признак необходимости перестройки
+    struct Chunk
+    {
+        std::vector<Layer> layers;
+        bool dirty = true;
+    };
+
+    // Запомнить карту, которую рисует draw: чанки других карт с теми же координатами выбрасываются,
+    // а при смене уровня той же ZLevelMap - перестраиваются
+    void selectSource(SourceKind kind, const void* source, int level);
+    // Перестроить вершины чанка по участку source [sourceX, sourceX + width) x [sourceY, sourceY + height),
+    // который лежит в мире начиная с тайла (worldX, worldY)
+    void rebuildChunk(Chunk& chunk, const TileGrid& source, int sourceX, int sourceY, int width, int height, int worldX, int worldY);
+    // Нарисовать слои чанка
+    void drawChunk(sf::RenderTarget& target, const Chunk& chunk);
+    // Освободить вершины невидимых чанков, если их накопилось слишком много
+    void releaseHiddenChunks(int firstX, int firstY, int lastX, int lastY);
+
+    int m_tileSize;                                    // Размер тайла
+    const TileRegistry& m_tileRegistry;                // Данные отрисовки типов тайлов
+    std::unordered_map<std::uint64_t, Chunk> m_chunks; // Чанки с построенными вершинами по World::chunkKey
+    int m_drawCalls;                                   // Вызовы draw за последнюю отрисовку
+    TileGrid m_decoded;                                // Распакованный чанк мира для перестройки вершин
+    SourceKind m_sourceKind;                           // Вид карты, для которой построены вершины
+    const void* m_source;                              // Карта, для которой построены вершины
+    int m_level;                                       // Уровень ZLevelMap, для которого построены вершины (-1 - нет)
+};
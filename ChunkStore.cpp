@@ -0,0 +1,214 @@
+#include "ChunkStore.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "World.h"
+
+namespace
+{
+    const char Magic[4] = { 'T', 'C', 'H', 'K' }; // Сигнатура журнала
+    const std::uint32_t Version = 2;              // Версия формата
+
+    // Заголовок журнала
+    struct FileHeader
+    {
+        char magic[4];            // Сигнатура Magic
+        std::uint32_t version;    // Версия формата
+        std::uint64_t seed;       // Зерно мира
+        std::int32_t worldHeight; // Высота мира в тайлах
+        std::int32_t chunkSize;   // Размер чанка в тайлах
+    };
+    static_assert(sizeof(FileHeader) == 24, "Chunk store header must have no padding");
+
+    // Заголовок записи чанка
+    struct RecordHeader
+    {
+        std::int32_t chunkX;
+        std::int32_t chunkY;
+        std::uint16_t width;
+        std::uint16_t height;
+    };
+    static_assert(sizeof(RecordHeader) == 12, "Chunk record header must have no padding");
+
+    const std::uint64_t FileHeaderSize = sizeof(FileHeader); // Размер заголовка файла
+}
+
+// Открыть журнал или создать пустой для мира с зерном seed, высотой worldHeight и чанками chunkSize
+ChunkStore::ChunkStore(const std::string& path, std::uint64_t seed, int worldHeight, int chunkSize)
+    : m_path(path)
+    , m_seed(seed)
+    , m_worldHeight(worldHeight)
+    , m_chunkSize(chunkSize)
+    , m_end(FileHeaderSize)
+{
+    if (worldHeight <= 0 || chunkSize <= 0 || chunkSize > 0xFFFF)
+    {
+        throw std::invalid_argument("Invalid chunk store world size");
+    }
+
+    m_file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+    if (!m_file)
+    {
+        // Файла нет - создать пустой журнал
+        FileHeader header;
+        std::memcpy(header.magic, Magic, sizeof(Magic));
+        header.version = Version;
+        header.seed = seed;
+        header.worldHeight = worldHeight;
+        header.chunkSize = chunkSize;
+        std::ofstream created(path, std::ios::binary);
+        created.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        created.close();
+        if (!created)
+        {
+            throw std::runtime_error("Failed to create chunk store: " + path);
+        }
+        m_file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+        if (!m_file)
+        {
+            throw std::runtime_error("Failed to open chunk store: " + path);
+        }
+        return;
+    }
+
+    FileHeader fileHeader;
+    m_file.read(reinterpret_cast<char*>(&fileHeader), sizeof(fileHeader));
+    if (!m_file || std::memcmp(fileHeader.magic, Magic, sizeof(Magic)) != 0)
+    {
+        throw std::runtime_error("Not a chunk store: " + path);
+    }
+    if (fileHeader.version != Version)
+    {
+        throw std::runtime_error("Unsupported chunk store version: " + std::to_string(fileHeader.version));
+    }
+    if (fileHeader.worldHeight <= 0 || fileHeader.chunkSize <= 0 || fileHeader.chunkSize > 0xFFFF)
+    {
+        throw std::runtime_error("Corrupt chunk store header: " + path);
+    }
+    m_seed = fileHeader.seed;
+    m_worldHeight = fileHeader.worldHeight;
+    m_chunkSize = fileHeader.chunkSize;
+
+    m_file.seekg(0, std::ios::end);
+    std::uint64_t fileSize = static_cast<std::uint64_t>(m_file.tellg());
+    m_file.seekg(static_cast<std::streamoff>(m_end));
+
+    // Пройти по записям; недописанная последняя запись (обрыв при записи) отбрасывается.
+    // Чанк любой записи должен иметь форму чанка мира: читатели раскладывают его строки в буферы ширины чанка
+    RecordHeader header;
+    while (m_end + sizeof(header) <= fileSize && m_file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+    {
+        if (!isChunkShape(header.chunkY, header.width, header.height))
+        {
+            throw std::runtime_error("Corrupt chunk store record: " + path);
+        }
+        std::uint64_t offset = m_end + sizeof(header);
+        std::uint64_t size = static_cast<std::uint64_t>(header.width) * header.height;
+        if (offset + size > fileSize)
+            break;
+
+        m_records[World::chunkKey(header.chunkX, header.chunkY)] = Record{ offset, header.width, header.height };
+        m_end = offset + size;
+        m_file.seekg(static_cast<std::streamoff>(m_end));
+    }
+    m_file.clear();
+}
+
+// Получить зерно мира журнала
+std::uint64_t ChunkStore::getSeed() const
+{
+    return m_seed;
+}
+
+// Получить высоту мира журнала в тайлах
+int ChunkStore::getWorldHeight() const
+{
+    return m_worldHeight;
+}
+
+// Получить размер чанка журнала в тайлах
+int ChunkStore::getChunkSize() const
+{
+    return m_chunkSize;
+}
+
+// Проверить, что в журнале есть чанк
+bool ChunkStore::contains(int chunkX, int chunkY) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_records.count(World::chunkKey(chunkX, chunkY)) != 0;
+}
+
+// Прочитать чанк; nullptr, если чанка в журнале нет
+std::unique_ptr<TileGrid> ChunkStore::read(int chunkX, int chunkY) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_records.find(World::chunkKey(chunkX, chunkY));
+    if (it == m_records.end())
+    {
+        return nullptr;
+    }
+
+    const Record& record = it->second;
+    std::unique_ptr<TileGrid> tiles(new TileGrid(record.width, record.height));
+    m_file.seekg(static_cast<std::streamoff>(record.offset));
+    m_file.read(reinterpret_cast<char*>(tiles->data()), static_cast<std::streamsize>(tiles->size()));
+    if (!m_file)
+    {
+        m_file.clear();
+        throw std::runtime_error("Failed to read chunk store: " + m_path);
+    }
+    return tiles;
+}
+
+// Дописать чанк в журнал (исключение при ошибке записи)
+void ChunkStore::write(int chunkX, int chunkY, const TileGrid& tiles)
+{
+    if (!isChunkShape(chunkY, tiles.getWidth(), tiles.getHeight()))
+    {
+        throw std::invalid_argument("Chunk does not match the chunk store world size");
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    RecordHeader header;
+    header.chunkX = chunkX;
+    header.chunkY = chunkY;
+    header.width = static_cast<std::uint16_t>(tiles.getWidth());
+    header.height = static_cast<std::uint16_t>(tiles.getHeight());
+
+    // Запись идёт поверх возможного обрывка после последней целой записи
+    m_file.seekp(static_cast<std::streamoff>(m_end));
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_file.write(reinterpret_cast<const char*>(tiles.data()), static_cast<std::streamsize>(tiles.size()));
+    m_file.flush();
+    if (!m_file)
+    {
+        m_file.clear();
+        throw std::runtime_error("Failed to write chunk store: " + m_path);
+    }
+
+    std::uint64_t offset = m_end + sizeof(header);
+    m_records[World::chunkKey(chunkX, chunkY)] = Record{ offset, tiles.getWidth(), tiles.getHeight() };
+    m_end = offset + tiles.size();
+}
+
+// Проверить, что чанк строки chunkY размером width x height имеет форму чанка мира журнала
+// (ширина - размер чанка, высота - размер чанка или остаток высоты мира у нижней строки)
+bool ChunkStore::isChunkShape(int chunkY, int width, int height) const
+{
+    if (chunkY < 0 || chunkY >= (m_worldHeight + m_chunkSize - 1) / m_chunkSize)
+    {
+        return false;
+    }
+    return width == m_chunkSize && height == std::min(m_chunkSize, m_worldHeight - chunkY * m_chunkSize);
+}
+
+// Получить количество чанков в журнале
+std::size_t ChunkStore::getChunkCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_records.size();
+}
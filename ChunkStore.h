@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "TileGrid.h"
+
+// Дисковое хранилище изменённых чанков неограниченного мира: файл-журнал, в конец которого
+// дописываются записи чанков (последняя запись чанка - актуальная). Индекс записей
+// строится при открытии и хранится в памяти. Методы можно вызывать из нескольких потоков.
+// Формат: сигнатура "TCHK", версия, зерно мира (uint64), высота мира и размер чанка (int32);
+// записи: x, y (int32), ширина, высота (uint16), тайлы построчно
+class ChunkStore
+{
+public:
+    // Открыть журнал или создать пустой для мира с зерном seed, высотой worldHeight и чанками chunkSize
+    // (у открытого журнала параметры мира берутся из файла). Исключение, если файл не открылся, это не журнал чанков
+    // или форма чанка какой-либо записи не совпадает с чанками мира журнала (журнал повреждён)
+    ChunkStore(const std::string& path, std::uint64_t seed, int worldHeight, int chunkSize);
+
+    // Получить зерно мира журнала
+    std::uint64_t getSeed() const;
+    // Получить высоту мира журнала в тайлах
+    int getWorldHeight() const;
+    // Получить размер чанка журнала в тайлах
+    int getChunkSize() const;
+
+    // Проверить, что в журнале есть чанк
+    bool contains(int chunkX, int chunkY) const;
+    // Прочитать чанк; nullptr, если чанка в журнале нет
+    std::unique_ptr<TileGrid> read(int chunkX, int chunkY) const;
+    // Дописать чанк в журнал (исключение, если форма чанка не совпадает с чанками мира журнала, или при ошибке записи)
+    void write(int chunkX, int chunkY, const TileGrid& tiles);
+    // Получить количество чанков в журнале
+    std::size_t getChunkCount() const;
+
+private:
+    // Проверить, что чанк строки chunkY размером width x height имеет форму чанка мира журнала
+    bool isChunkShape(int chunkY, int width, int height) const;
+
+    // Расположение записи чанка в файле
+    struct Record
+    {
+        std::uint64_t offset; // Смещение тайлов от начала файла
+        int width;            // Ширина чанка
+        int height;           // Высота чанка
+    };
+
+    std::string m_path;                                 // Путь к журналу
+    std::uint64_t m_seed;                               // Зерно мира
+    int m_worldHeight;                                  // Высота мира в тайлах
+    int m_chunkSize;                                    // Размер чанка в тайлах
+    mutable std::fstream m_file;                        // Журнал (чтение и дозапись)
+    std::unordered_map<std::uint64_t, Record> m_records; // Последние записи чанков по World::chunkKey
+    std::uint64_t m_end;                                // Конец последней целой записи
+    mutable std::mutex m_mutex;                         // Защита файла и индекса
+};
@@ -0,0 +1,179 @@
+#include "ChunkStreamer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+
+namespace
+{
+    const float LookAheadSeconds = 0.75f; // На сколько вперёд предсказывать положение камеры
+    const float VelocitySmoothing = 0.2f; // Доля новой скорости при сглаживании
+    const float RetryDelaySeconds = 1.0f; // Через сколько заказывать снова чанк, который не удалось загрузить
+}
+
+// Создать генератор для мира (мир должен жить дольше генератора), 0 потоков - по числу ядер
+ChunkStreamer::ChunkStreamer(World& world, unsigned threadCount)
+    : m_world(world)
+    , m_hasLastCenter(false)
+    , m_time(0.0f)
+    , m_pool(threadCount)
+{
+}
+
+// Забрать готовые чанки в мир и заказать новые по видимому прямоугольнику (в тайлах)
+// и времени кадра; вернуть прямоугольники добавленных чанков (в тайлах)
+std::vector<sf::IntRect> ChunkStreamer::update(const sf::IntRect& visibleTiles, sf::Time elapsed)
+{
+    const int chunkSize = World::ChunkSize;
+    m_time += elapsed.asSeconds();
+
+    // Забрать всё, что рабочие потоки успели сделать
+    std::vector<sf::IntRect> added;
+    FinishedChunk finished;
+    while (m_finished.tryPop(finished))
+    {
+        std::uint64_t key = World::chunkKey(finished.chunkX, finished.chunkY);
+        m_pending.erase(key);
+
+        // Ошибка может быть временной (например, чтение хранилища): чанк заказывается снова через
+        // RetryDelaySeconds, но не больше MaxLoadAttempts раз подряд, чтобы не повторять постоянную ошибку каждый кадр
+        if (!finished.error.empty())
+        {
+            FailedChunk& failed = m_failed[key];
+            ++failed.attempts;
+            failed.retryTime = m_time + RetryDelaySeconds;
+            m_errors.push_back("Chunk (" + std::to_string(finished.chunkX) + ", " + std::to_string(finished.chunkY) + "): " + finished.error
+                + (failed.attempts < MaxLoadAttempts ? " (will retry)" : " (giving up)"));
+            continue;
+        }
+        m_failed.erase(key);
+
+        // Пока чанк готовился, мир мог записать в хранилище его изменённую версию:
+        // такой результат устарел, чанк будет заказан заново
+        if (finished.writeBackCount != m_world.getWriteBackCount())
+            continue;
+        if (!m_world.hasChunk(finished.chunkX, finished.chunkY))
+        {
+            sf::IntRect rect(finished.chunkX * chunkSize, finished.chunkY * chunkSize, finished.tiles.getWidth(), finished.tiles.getHeight());
+            m_world.insertChunk(finished.chunkX, finished.chunkY, std::move(finished.tiles));
+            added.push_back(rect);
+        }
+    }
+
+    if (visibleTiles.width <= 0 || visibleTiles.height <= 0)
+    {
+        return added;
+    }
+
+    // Скорость камеры по смещению центра видимой области
+    sf::Vector2f center(visibleTiles.left + visibleTiles.width * 0.5f, visibleTiles.top + visibleTiles.height * 0.5f);
+    float seconds = elapsed.asSeconds();
+    if (m_hasLastCenter && seconds > 0.0f)
+    {
+        sf::Vector2f velocity = (center - m_lastCenter) / seconds;
+        m_velocity += (velocity - m_velocity) * VelocitySmoothing;
+    }
+    m_lastCenter = center;
+    m_hasLastCenter = true;
+
+    // Область заказа: видимая и предсказанная через LookAheadSeconds, с запасом
+    sf::Vector2f shift = m_velocity * LookAheadSeconds;
+    float left = std::min<float>(visibleTiles.left, visibleTiles.left + shift.x);
+    float top = std::min<float>(visibleTiles.top, visibleTiles.top + shift.y);
+    float right = std::max<float>(visibleTiles.left, visibleTiles.left + shift.x) + visibleTiles.width;
+    float bottom = std::max<float>(visibleTiles.top, visibleTiles.top + shift.y) + visibleTiles.height;
+
+    int firstX = floorDiv(static_cast<int>(std::floor(left)), chunkSize) - MarginChunks;
+    int lastX = floorDiv(static_cast<int>(std::ceil(right)) - 1, chunkSize) + MarginChunks;
+    int firstY = std::max(0, floorDiv(static_cast<int>(std::floor(top)), chunkSize) - MarginChunks);
+    int lastY = std::min(m_world.getChunkCountY() - 1, floorDiv(static_cast<int>(std::ceil(bottom)) - 1, chunkSize) + MarginChunks);
+
+    std::vector<sf::Vector2i> wanted;
+    for (int chunkY = firstY; chunkY <= lastY; ++chunkY)
+    {
+        for (int chunkX = firstX; chunkX <= lastX; ++chunkX)
+        {
+            if (m_world.hasChunk(chunkX, chunkY))
+                m_world.touchChunk(chunkX, chunkY);
+            else if (canRequest(World::chunkKey(chunkX, chunkY)))
+                wanted.push_back(sf::Vector2i(chunkX, chunkY));
+        }
+    }
+
+    // Сначала ближайшие к текущему центру: видимые чанки раньше предсказанных
+    auto distance = [&](const sf::Vector2i& chunk)
+    {
+        float dx = (chunk.x + 0.5f) * chunkSize - center.x;
+        float dy = (chunk.y + 0.5f) * chunkSize - center.y;
+        return dx * dx + dy * dy;
+    };
+    std::sort(wanted.begin(), wanted.end(), [&](const sf::Vector2i& a, const sf::Vector2i& b)
+    {
+        return distance(a) < distance(b);
+    });
+
+    std::size_t maxPending = static_cast<std::size_t>(m_pool.getThreadCount()) * PendingPerThread;
+    for (const sf::Vector2i& chunk : wanted)
+    {
+        if (m_pending.size() >= maxPending)
+            break;
+        request(chunk.x, chunk.y);
+    }
+    return added;
+}
+
+// Получить количество чанков, которые сейчас генерируются
+int ChunkStreamer::getPendingCount() const
+{
+    return static_cast<int>(m_pending.size());
+}
+
+// Забрать сообщения о чанках, которые не удалось загрузить с прошлого вызова
+std::vector<std::string> ChunkStreamer::takeErrors()
+{
+    std::vector<std::string> errors;
+    errors.swap(m_errors);
+    return errors;
+}
+
+// Можно ли заказать чанк, который ещё не в мире (не заказан и не отложен после неудачной загрузки)
+bool ChunkStreamer::canRequest(std::uint64_t key) const
+{
+    if (m_pending.count(key) != 0)
+        return false;
+    auto failed = m_failed.find(key);
+    return failed == m_failed.end() || (failed->second.attempts < MaxLoadAttempts && m_time >= failed->second.retryTime);
+}
+
+// Заказать генерацию чанка на рабочем потоке
+void ChunkStreamer::request(int chunkX, int chunkY)
+{
+    m_pending.insert(World::chunkKey(chunkX, chunkY));
+
+    // Генерация или чтение чанка не меняет мир, поэтому идёт параллельно с отрисовкой
+    const World& world = m_world;
+    MpscQueue<FinishedChunk>& finished = m_finished;
+    std::uint64_t writeBackCount = m_world.getWriteBackCount();
+    m_pool.submit([&world, &finished, chunkX, chunkY, writeBackCount]()
+    {
+        FinishedChunk chunk;
+        chunk.chunkX = chunkX;
+        chunk.chunkY = chunkY;
+        chunk.writeBackCount = writeBackCount;
+
+        // Ошибка чтения хранилища передаётся потоку отрисовки вместо чанка, чтобы он снял заказ
+        try
+        {
+            chunk.tiles = world.loadChunk(chunkX, chunkY);
+        }
+        catch (const std::exception& error)
+        {
+            chunk.error = error.what();
+        }
+        catch (...)
+        {
+            chunk.error = "unknown error";
+        }
+        finished.push(std::move(chunk));
+    });
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "MpscQueue.h"
+#include "ThreadPool.h"
+#include "PackedChunk.h"
+#include "World.h"
+
+// Фоновая генерация чанков мира впереди камеры. Рабочие потоки генерируют чанки,
+// которые скоро станут видимыми (по положению и скорости камеры), и передают их
+// потоку отрисовки через неблокирующую очередь; кадр никогда не ждёт генерацию.
+// Чанки в памяти вокруг камеры отмечаются каждый кадр, чтобы мир вытеснял дальние
+class ChunkStreamer
+{
+public:
+    static const int MarginChunks = 1;      // Запас чанков вокруг видимой области
+    static const int PendingPerThread = 4;  // Сколько чанков в работе на один поток
+    static const int MaxLoadAttempts = 3;   // Сколько раз подряд заказывать чанк, который не удаётся загрузить
+
+    // Создать генератор для мира (мир должен жить дольше генератора), 0 потоков - по числу ядер
+    explicit ChunkStreamer(World& world, unsigned threadCount = 0);
+
+    // Забрать готовые чанки в мир и заказать новые по видимому прямоугольнику (в тайлах)
+    // и времени кадра; вернуть прямоугольники добавленных чанков (в тайлах)
+    std::vector<sf::IntRect> update(const sf::IntRect& visibleTiles, sf::Time elapsed);
+    // Получить количество чанков, которые сейчас генерируются
+    int getPendingCount() const;
+    // Забрать сообщения о чанках, которые не удалось загрузить с прошлого вызова (такой чанк заказывается
+    // снова не раньше чем через секунду; после MaxLoadAttempts неудач подряд он больше не заказывается и остаётся пустым)
+    std::vector<std::string> takeErrors();
+
+private:
+    // Готовый чанк от рабочего потока
+    struct FinishedChunk
+    {
+        int chunkX = 0;
+        int chunkY = 0;
+        std::uint64_t writeBackCount = 0; // Счётчик записей мира в хранилище на момент заказа
+        PackedChunk tiles;
+        std::string error;                // Ошибка загрузки (пусто, если чанк готов)
+    };
+
+    // Неудачные попытки загрузить чанк
+    struct FailedChunk
+    {
+        int attempts = 0;       // Неудач подряд
+        float retryTime = 0.0f; // Время (m_time), раньше которого чанк не заказывается снова
+    };
+
+    // Заказать генерацию чанка на рабочем потоке
+    void request(int chunkX, int chunkY);
+    // Можно ли заказать чанк, который ещё не в мире (не заказан и не отложен после неудачной загрузки)
+    bool canRequest(std::uint64_t key) const;
+
+    World& m_world;                              // Мир, в который добавляются чанки
+    MpscQueue<FinishedChunk> m_finished;         // Готовые чанки (рабочие потоки -> поток отрисовки)
+    std::unordered_set<std::uint64_t> m_pending; // Заказанные, но не полученные чанки (только поток отрисовки)
+    std::unordered_map<std::uint64_t, FailedChunk> m_failed; // Чанки, которые не удалось загрузить в прошлый раз
+    std::vector<std::string> m_errors;           // Сообщения об ошибках, ещё не забранные takeErrors
+    sf::Vector2f m_lastCenter;                   // Центр видимой области в прошлом кадре (в тайлах)
+    sf::Vector2f m_velocity;                     // Сглаженная скорость камеры (тайлов в секунду)
+    bool m_hasLastCenter;                        // Прошлый центр известен
+    float m_time;                                // Время с создания генератора (сумма времени кадров, секунды)
+    ThreadPool m_pool;                           // Рабочие потоки (останавливаются первыми при разрушении)
+};
@@ -0,0 +1,188 @@
+#include "GameDefinitions.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "TerrainGenerator.h"
+#include "TileRegistry.h"
+
+namespace
+{
+    // Тайл, который генератор рельефа ставит под фиксированным индексом
+    struct TerrainTile
+    {
+        TileId id;        // Индекс, который пишет генератор
+        const char* name; // Имя, под которым тайл должен быть объявлен
+    };
+
+    const TerrainTile TerrainTiles[] =
+    {
+        { GrassTile, "ground_with_grass" },
+        { SkyTile, "sky" },
+        { RockTile, "rock" }
+    };
+
+    // Получить флаг тайла по слову из файла (0, если слово не флаг)
+    std::uint8_t parseFlag(const std::string& word)
+    {
+        if (word == "solid")
+            return TileSolid;
+        if (word == "mineable")
+            return TileMineable;
+        if (word == "ore")
+            return TileOre;
+        return 0;
+    }
+
+    // Прочитать ключевое слово и следом за ним count чисел
+    template <typename T>
+    bool parseValues(std::istringstream& line, const char* keyword, T* values, int count)
+    {
+        std::string word;
+        if (!(line >> word) || word != keyword)
+            return false;
+        for (int i = 0; i < count; ++i)
+        {
+            if (!(line >> values[i]))
+                return false;
+        }
+        return true;
+    }
+}
+
+// Прочитать и проверить файл определений (исключение с номером строки при ошибке)
+GameDefinitions::GameDefinitions(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open definitions file: " + path);
+    }
+
+    std::string text;
+    for (int lineNumber = 1; std::getline(file, text); ++lineNumber)
+    {
+        std::string where = " in " + path + " at line " + std::to_string(lineNumber);
+        std::istringstream line(text.substr(0, text.find('#')));
+        std::string kind;
+        if (!(line >> kind))
+            continue;
+
+        if (kind == "tile")
+        {
+            TileDefinition tile;
+            if (!(line >> tile.name >> tile.texturePath))
+            {
+                throw std::runtime_error("Expected tile name and texture" + where);
+            }
+            if (findTile(tile.name) >= 0)
+            {
+                throw std::runtime_error("Tile " + tile.name + " is already defined" + where);
+            }
+            if (m_tiles.size() >= static_cast<std::size_t>(TileRegistry::MaxTileTypes))
+            {
+                throw std::runtime_error("Too many tiles" + where);
+            }
+            for (std::string word; line >> word;)
+            {
+                std::uint8_t flag = parseFlag(word);
+                if (flag == 0)
+                {
+                    throw std::runtime_error("Unknown tile flag " + word + where);
+                }
+                tile.flags |= flag;
+            }
+            m_tiles.push_back(tile);
+        }
+        else if (kind == "resource")
+        {
+            std::string name;
+            double depth[2];
+            double chance[2];
+            int vein[3];
+            if (!(line >> name) || !parseValues(line, "depth", depth, 2) || !parseValues(line, "chance", chance, 2)
+                || !parseValues(line, "vein", vein, 3))
+            {
+                throw std::runtime_error("Expected resource <tile> depth <top> <bottom> chance <top> <bottom> vein <spacing> <min> <max>" + where);
+            }
+            std::string extra;
+            if (line >> extra)
+            {
+                throw std::runtime_error("Unexpected " + extra + where);
+            }
+
+            int tile = findTile(name);
+            if (tile < 0)
+            {
+                throw std::runtime_error("Unknown tile " + name + where);
+            }
+            if (!(m_tiles[tile].flags & TileOre))
+            {
+                throw std::runtime_error("Tile " + name + " is not an ore" + where);
+            }
+            for (const ResourceDefinition& other : m_resources)
+            {
+                if (other.tile == tile)
+                {
+                    throw std::runtime_error("Resource " + name + " is already defined" + where);
+                }
+            }
+
+            ResourceDefinition resource;
+            resource.tile = static_cast<TileId>(tile);
+            resource.top = depth[0];
+            resource.bottom = depth[1];
+            resource.chanceTop = chance[0];
+            resource.chanceBottom = chance[1];
+            resource.veinSpacing = vein[0];
+            resource.veinMinSize = vein[1];
+            resource.veinMaxSize = vein[2];
+            try
+            {
+                validateResourceDefinition(resource);
+            }
+            catch (const std::invalid_argument& error)
+            {
+                throw std::runtime_error(error.what() + where);
+            }
+            m_resources.push_back(resource);
+        }
+        else
+        {
+            throw std::runtime_error("Unknown definition " + kind + where);
+        }
+    }
+
+    // Генератор рельефа пишет небо, землю и камень прямо индексами
+    for (const TerrainTile& terrain : TerrainTiles)
+    {
+        if (findTile(terrain.name) != terrain.id)
+        {
+            throw std::runtime_error(std::string("Tile ") + terrain.name + " must be defined with id " + std::to_string(terrain.id) + " in " + path);
+        }
+    }
+}
+
+// Получить описания тайлов в порядке индексов
+const std::vector<TileDefinition>& GameDefinitions::getTiles() const
+{
+    return m_tiles;
+}
+
+// Получить описания руд в порядке их проверки генератором
+const std::vector<ResourceDefinition>& GameDefinitions::getResources() const
+{
+    return m_resources;
+}
+
+// Найти индекс тайла по имени (-1, если тайла нет)
+int GameDefinitions::findTile(const std::string& name) const
+{
+    for (std::size_t i = 0; i < m_tiles.size(); ++i)
+    {
+        if (m_tiles[i].name == name)
+            return static_cast<int>(i);
+    }
+    return -1;
+}
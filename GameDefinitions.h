@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ResourceTables.h"
+
+// Описание типа тайла (из файла определений)
+struct TileDefinition
+{
+    std::string name;        // Имя типа
+    std::string texturePath; // Файл текстуры
+    std::uint8_t flags = 0;  // Флаги TileFlags
+};
+
+// Определения тайлов и руд из текстового файла, чтобы настраивать генерацию без пересборки.
+// Строки файла (пустые строки и текст после '#' пропускаются):
+//   tile <имя> <файл текстуры> [solid] [mineable] [ore]
+//   resource <тайл> depth <от %> <до %> chance <в начале %> <в конце %> vein <разнос> <длина от> <длина до>
+// Шанс руды действует при любом размещении: при размещении жилами по нему подбирается плотность затравок.
+// Индексы тайлов выдаются по порядку строк tile. Файл проверяется целиком при загрузке,
+// а руды компилируются в ResourceTables, поэтому генерация не платит за разбор ни на одной клетке
+class GameDefinitions
+{
+public:
+    // Прочитать и проверить файл определений (исключение с номером строки при ошибке)
+    explicit GameDefinitions(const std::string& path);
+
+    // Получить описания тайлов в порядке индексов
+    const std::vector<TileDefinition>& getTiles() const;
+    // Получить описания руд в порядке их проверки генератором
+    const std::vector<ResourceDefinition>& getResources() const;
+
+private:
+    // Найти индекс тайла по имени (-1, если тайла нет)
+    int findTile(const std::string& name) const;
+
+    std::vector<TileDefinition> m_tiles;         // Тайлы по индексу
+    std::vector<ResourceDefinition> m_resources; // Руды
+};
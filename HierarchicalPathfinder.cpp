@@ -0,0 +1,762 @@
+#include "HierarchicalPathfinder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "ThreadPool.h"
+
+namespace
+{
+    const float DiagonalCost = 1.41421356f;                           // Цена хода по диагонали
+    const float Unreachable = std::numeric_limits<float>::infinity(); // Расстояние до недостижимой клетки
+    const int EntranceSplitLength = 6;                                // Вход от этой длины получает два узла по краям, короче - один посередине
+    const int ClusterBandSize = 16;                                   // Кластеров в полосе при параллельной перестройке
+
+    // Оценка длины пути с ходами в 8 сторон (октильное расстояние)
+    float octileDistance(int x0, int y0, int x1, int y1)
+    {
+        int dx = std::abs(x1 - x0);
+        int dy = std::abs(y1 - y0);
+        return static_cast<float>(std::max(dx, dy)) + (DiagonalCost - 1.0f) * static_cast<float>(std::min(dx, dy));
+    }
+}
+
+// Поиск пути по клеткам одного кластера: Дейкстра до всех клеток или A* до одной.
+// Проходимость кластера копируется в массив с рамкой из непроходимых клеток,
+// поэтому соседей клетки проверяют без проверок границ и обращений к карте
+class HierarchicalPathfinder::ClusterSearch
+{
+public:
+    // Выбрать кластер (область bounds карты grid) и прочитать его проходимость
+    void load(const PathGrid& grid, const sf::IntRect& bounds)
+    {
+        m_bounds = bounds;
+        std::fill(m_open, m_open + Cells, false);
+        for (int y = 0; y < bounds.height; ++y)
+        {
+            const std::uint64_t* words = grid.row(bounds.top + y);
+            bool* open = m_open + cell(bounds.left, bounds.top + y);
+            for (int x = 0; x < bounds.width; ++x)
+            {
+                int column = bounds.left + x;
+                open[x] = (words[column >> 6] >> (column & 63) & 1) != 0;
+            }
+        }
+    }
+
+    // Найти расстояния от (startX, startY) до всех клеток кластера
+    void fill(int startX, int startY)
+    {
+        run(startX, startY, -1);
+    }
+
+    // Найти путь от (startX, startY) до (goalX, goalY) внутри кластера, вернуть его длину
+    float search(int startX, int startY, int goalX, int goalY)
+    {
+        m_goalX = goalX;
+        m_goalY = goalY;
+        return run(startX, startY, cell(goalX, goalY));
+    }
+
+    // Получить расстояние до клетки кластера после fill или search (бесконечность, если не достигнута)
+    float distance(int x, int y) const
+    {
+        return m_cost[cell(x, y)];
+    }
+
+    // Дописать в path клетки найденного пути до (goalX, goalY), без начальной клетки
+    void appendPath(int goalX, int goalY, std::vector<sf::Vector2i>& path) const
+    {
+        std::size_t first = path.size();
+        for (int current = cell(goalX, goalY); m_parent[current] != current; current = m_parent[current])
+        {
+            path.push_back(position(current));
+        }
+        std::reverse(path.begin() + first, path.end());
+    }
+
+private:
+    static const int Stride = HierarchicalPathfinder::ClusterSize + 2; // Ширина массивов с рамкой
+    static const int Cells = Stride * Stride;                          // Клеток в массивах с рамкой
+    static const int BucketCount = 3;                                  // Корзин Дейкстры (по ширине 1)
+
+    // Элемент открытого списка
+    struct Entry
+    {
+        float priority; // Оценка длины пути через клетку
+        float cost;     // Длина пути до клетки
+        int cell;       // Клетка в массивах с рамкой
+
+        // Наверху кучи - наименьшая оценка, при равных оценках - клетка дальше от начала:
+        // на открытом месте у многих клеток оценки равны, и без этого A* обходит их все
+        bool operator<(const Entry& other) const
+        {
+            return priority > other.priority || (priority == other.priority && cost < other.cost);
+        }
+    };
+
+    // Получить клетку массивов с рамкой по координатам карты
+    int cell(int x, int y) const { return (y - m_bounds.top + 1) * Stride + (x - m_bounds.left + 1); }
+    // Получить координаты карты по клетке массивов с рамкой
+    sf::Vector2i position(int current) const
+    {
+        return sf::Vector2i(m_bounds.left + current % Stride - 1, m_bounds.top + current / Stride - 1);
+    }
+
+    // Поиск от (startX, startY); goal < 0 - до всех клеток кластера
+    float run(int startX, int startY, int goal)
+    {
+        std::fill(m_cost, m_cost + Cells, Unreachable);
+        std::fill(m_closed, m_closed + Cells, false);
+        int start = cell(startX, startY);
+        m_cost[start] = 0.0f;
+        m_parent[start] = static_cast<std::int16_t>(start);
+
+        if (goal < 0)
+        {
+            // Дейкстра с корзинами шириной 1 (алгоритм Диала): ход стоит не меньше 1, поэтому клетки
+            // одной корзины друг друга не улучшают и обрабатываются в любом порядке, а ход не длиннее 2
+            // кладёт клетку не дальше чем на две корзины вперёд - хватает трёх корзин по кругу
+            for (auto& bucket : m_buckets)
+                bucket.clear();
+            m_buckets[0].push_back(start);
+            for (int index = 0, pending = 1; pending > 0; ++index)
+            {
+                std::vector<int>& bucket = m_buckets[index % BucketCount];
+                for (std::size_t i = 0; i < bucket.size(); ++i)
+                {
+                    int current = bucket[i];
+                    if (!m_closed[current])
+                    {
+                        m_closed[current] = true;
+                        pending += expand(current, -1);
+                    }
+                }
+                pending -= static_cast<int>(bucket.size());
+                bucket.clear();
+            }
+            return 0.0f;
+        }
+
+        m_heap.clear();
+        m_heap.push_back({ 0.0f, 0.0f, start });
+        while (!m_heap.empty())
+        {
+            std::pop_heap(m_heap.begin(), m_heap.end());
+            int current = m_heap.back().cell;
+            m_heap.pop_back();
+            if (m_closed[current])
+                continue;
+            m_closed[current] = true;
+            if (current == goal)
+                return m_cost[current];
+            expand(current, goal);
+        }
+        return Unreachable;
+    }
+
+    // Улучшить пути до соседей клетки current, вернуть количество добавленных в открытый список
+    int expand(int current, int goal)
+    {
+        // Смещения ходов в массивах с рамкой: четыре по сторонам, затем по диагонали
+        // (ход по диагонали разрешён, только если открыты обе клетки по сторонам от него)
+        static const int Step[8] = { 1, -1, Stride, -Stride, Stride + 1, Stride - 1, -Stride + 1, -Stride - 1 };
+        static const int SideX[4] = { 0, 1, 0, 1 };
+        static const int SideY[4] = { 2, 2, 3, 3 };
+
+        int added = 0;
+        bool side[4];
+        for (int d = 0; d < 4; ++d)
+        {
+            side[d] = m_open[current + Step[d]];
+            if (side[d])
+                added += relax(current, current + Step[d], 1.0f, goal);
+        }
+        for (int d = 0; d < 4; ++d)
+        {
+            if (side[SideX[d]] && side[SideY[d]] && m_open[current + Step[d + 4]])
+                added += relax(current, current + Step[d + 4], DiagonalCost, goal);
+        }
+        return added;
+    }
+
+    // Улучшить путь до клетки next через клетку current, вернуть 1, если клетка добавлена в открытый список
+    int relax(int current, int next, float step, int goal)
+    {
+        float cost = m_cost[current] + step;
+        if (!(cost < m_cost[next]))
+            return 0;
+
+        m_cost[next] = cost;
+        m_parent[next] = static_cast<std::int16_t>(current);
+        if (goal < 0)
+        {
+            m_buckets[static_cast<int>(cost) % BucketCount].push_back(next);
+        }
+        else
+        {
+            sf::Vector2i p = position(next);
+            m_heap.push_back({ cost + octileDistance(p.x, p.y, m_goalX, m_goalY), cost, next });
+            std::push_heap(m_heap.begin(), m_heap.end());
+        }
+        return 1;
+    }
+
+    sf::IntRect m_bounds;                    // Кластер
+    int m_goalX = 0;                         // Столбец цели поиска search
+    int m_goalY = 0;                         // Строка цели поиска search
+    bool m_open[Cells];                      // Проходимость клеток (рамка непроходима)
+    float m_cost[Cells];                     // Расстояния до клеток
+    std::int16_t m_parent[Cells];            // Предыдущая клетка пути
+    bool m_closed[Cells];                    // Клетка обработана
+    std::vector<Entry> m_heap;               // Открытый список A* (двоичная куча)
+    std::vector<int> m_buckets[BucketCount]; // Открытый список Дейкстры: корзины по целой части расстояния
+};
+
+// Построить абстрактный граф по карте проходимости (pool - пул потоков для кластеров или nullptr)
+HierarchicalPathfinder::HierarchicalPathfinder(PathGrid grid, ThreadPool* pool)
+    : m_grid(std::move(grid))
+    , m_clustersX((m_grid.getWidth() + ClusterSize - 1) / ClusterSize)
+    , m_clustersY((m_grid.getHeight() + ClusterSize - 1) / ClusterSize)
+    , m_rebuiltClusterCount(0)
+    , m_search(0)
+    , m_clusterSearch(new ClusterSearch())
+{
+    int clusterCount = m_clustersX * m_clustersY;
+    m_clusters.resize(clusterCount);
+    m_borders[0].resize(clusterCount);
+    m_borders[1].resize(clusterCount);
+    m_borderDirty.assign(static_cast<std::size_t>(clusterCount) * 2, 0);
+    m_clusterDirty.assign(clusterCount, 0);
+    for (int cluster = 0; cluster < clusterCount; ++cluster)
+    {
+        markBorder(cluster, 0);
+        markBorder(cluster, 1);
+    }
+    rebuild(pool);
+}
+
+HierarchicalPathfinder::~HierarchicalPathfinder() = default;
+
+// Получить карту проходимости
+const PathGrid& HierarchicalPathfinder::getGrid() const
+{
+    return m_grid;
+}
+
+// Изменить проходимость клетки; затронутые кластеры перестраиваются перед следующим поиском
+void HierarchicalPathfinder::setPassable(int x, int y, bool passable)
+{
+    if (m_grid.contains(x, y) && m_grid.isPassable(x, y) == passable)
+    {
+        return;
+    }
+    m_grid.setPassable(x, y, passable);
+
+    // Расстояния внутри кластера меняются всегда, входы - только если клетка лежит на его краю
+    int cluster = clusterOf(x, y);
+    int localX = x % ClusterSize;
+    int localY = y % ClusterSize;
+    markCluster(cluster);
+    if (localX == 0 && x > 0)
+        markBorder(cluster - 1, 0);
+    if (localX == ClusterSize - 1)
+        markBorder(cluster, 0);
+    if (localY == 0 && y > 0)
+        markBorder(cluster - m_clustersX, 1);
+    if (localY == ClusterSize - 1)
+        markBorder(cluster, 1);
+}
+
+// Перестроить изменённые кластеры сейчас (pool - пул потоков для кластеров или nullptr)
+void HierarchicalPathfinder::rebuild(ThreadPool* pool)
+{
+    // Входы ищутся последовательно (они занимают узлы), затем кластеры собирают узлы своих границ
+    for (int border : m_dirtyBorders)
+    {
+        m_borderDirty[border] = 0;
+        buildBorder(border / 2, border % 2);
+    }
+    m_dirtyBorders.clear();
+    for (int cluster : m_dirtyClusters)
+    {
+        gatherNodes(cluster);
+    }
+
+    // Расстояния внутри кластеров независимы, их можно считать на потоках пула
+    auto computeBand = [this](int begin, int end)
+    {
+        std::unique_ptr<ClusterSearch> search(new ClusterSearch());
+        for (int i = begin; i < end; ++i)
+        {
+            computeCosts(m_dirtyClusters[i], *search);
+        }
+    };
+    int count = static_cast<int>(m_dirtyClusters.size());
+    if (pool)
+        pool->parallelFor(count, ClusterBandSize, computeBand);
+    else
+        computeBand(0, count);
+
+    // Номер перестройки отличает новые расстояния кластера от сохранённых до неё
+    for (int cluster : m_dirtyClusters)
+    {
+        m_clusterDirty[cluster] = 0;
+        m_clusters[cluster].version = ++m_rebuiltClusterCount;
+    }
+    m_dirtyClusters.clear();
+}
+
+// Найти путь из start в goal: path получает клетки пути от start до goal включительно
+bool HierarchicalPathfinder::findPath(sf::Vector2i start, sf::Vector2i goal, std::vector<sf::Vector2i>& path)
+{
+    path.clear();
+    if (!m_grid.isPassable(start.x, start.y) || !m_grid.isPassable(goal.x, goal.y))
+    {
+        return false;
+    }
+    if (start == goal)
+    {
+        path.push_back(start);
+        return true;
+    }
+    rebuild();
+
+    // Начало и цель - временные узлы после узлов графа
+    const int startNode = static_cast<int>(m_nodes.size());
+    const int goalNode = startNode + 1;
+    if (m_cost.size() < m_nodes.size() + 2)
+    {
+        m_cost.resize(m_nodes.size() + 2);
+        m_parent.resize(m_nodes.size() + 2);
+        m_visit.resize(m_nodes.size() + 2, 0);
+        m_flooded.resize(m_nodes.size() + 2, 0);
+    }
+    if (++m_search == 0)
+    {
+        std::fill(m_visit.begin(), m_visit.end(), 0);
+        std::fill(m_flooded.begin(), m_flooded.end(), 0);
+        m_search = 1;
+    }
+    m_open.clear();
+
+    // Расстояния от цели до узлов её кластера (граф неориентированный, поэтому и от узлов до цели) и от начала
+    const int startCluster = clusterOf(start.x, start.y);
+    const int goalCluster = clusterOf(goal.x, goal.y);
+    const std::vector<float>& goalCosts = fillCluster(m_goalFill, goal);
+    const std::vector<float>& startCosts = fillCluster(m_startFill, start);
+
+    // Из начала - к узлам его кластера и, если цель в том же кластере, прямо к ней
+    m_visit[startNode] = m_search;
+    m_cost[startNode] = 0.0f;
+    m_parent[startNode] = startNode;
+    const Cluster& origin = m_clusters[startCluster];
+    for (std::size_t i = 0; i < origin.nodes.size(); ++i)
+    {
+        if (startCosts[i] < Unreachable)
+            relax(origin.nodes[i], startCosts[i], startNode, goal);
+    }
+    bool reachable = false;
+    if (startCluster == goalCluster)
+    {
+        float cost;
+        if (followStraight(start, goal, nullptr))
+        {
+            cost = octileDistance(start.x, start.y, goal.x, goal.y);
+        }
+        else
+        {
+            m_clusterSearch->load(m_grid, getClusterBounds(startCluster));
+            cost = m_clusterSearch->search(start.x, start.y, goal.x, goal.y);
+        }
+        reachable = cost < Unreachable;
+        if (reachable)
+            relax(goalNode, cost, startNode, goal);
+    }
+
+    // Обход графа от цели: достигнутый им узел, до которого есть путь от начала (его уже достиг A*
+    // или до него прямой путь от начала в кластере), доказывает, что путь есть, а если обход кончился раньше,
+    // цель лежит в отдельной области и искать дальше нечего
+    m_flood.clear();
+    auto flood = [&](int node)
+    {
+        if (m_flooded[node] == m_search)
+            return false;
+        m_flooded[node] = m_search;
+        m_flood.push_back(node);
+        const Node& reached = m_nodes[node];
+        return m_visit[node] == m_search || (reached.cluster == startCluster && startCosts[reached.local] < Unreachable);
+    };
+    const Cluster& target = m_clusters[goalCluster];
+    for (std::size_t i = 0; i < target.nodes.size() && !reachable; ++i)
+    {
+        if (goalCosts[i] < Unreachable)
+            reachable = flood(target.nodes[i]);
+    }
+
+    // A* по абстрактному графу, на каждый раскрытый узел - шаг обхода от цели, пока путь не доказан
+    bool found = false;
+    std::size_t floodNext = 0;
+    while (!m_open.empty())
+    {
+        if (!reachable)
+        {
+            if (floodNext == m_flood.size())
+                break;
+            const Node& node = m_nodes[m_flood[floodNext++]];
+            reachable = flood(node.twin);
+            const Cluster& cluster = m_clusters[node.cluster];
+            const float* costs = cluster.costs.data() + static_cast<std::size_t>(node.local) * cluster.nodes.size();
+            for (std::size_t i = 0; i < cluster.nodes.size() && !reachable; ++i)
+            {
+                if (costs[i] < Unreachable)
+                    reachable = flood(cluster.nodes[i]);
+            }
+        }
+
+        std::pop_heap(m_open.begin(), m_open.end());
+        OpenEntry entry = m_open.back();
+        m_open.pop_back();
+        if (entry.node == goalNode)
+        {
+            found = true;
+            break;
+        }
+
+        // Устаревшая запись: до узла уже нашёлся путь короче
+        const Node& node = m_nodes[entry.node];
+        float cost = m_cost[entry.node];
+        if (entry.priority > cost + octileDistance(node.x, node.y, goal.x, goal.y))
+            continue;
+
+        relax(node.twin, cost + 1.0f, entry.node, goal);
+        const Cluster& cluster = m_clusters[node.cluster];
+        const float* costs = cluster.costs.data() + static_cast<std::size_t>(node.local) * cluster.nodes.size();
+        for (std::size_t i = 0; i < cluster.nodes.size(); ++i)
+        {
+            if (costs[i] < Unreachable && static_cast<int>(i) != node.local)
+                relax(cluster.nodes[i], cost + costs[i], entry.node, goal);
+        }
+        if (node.cluster == goalCluster && goalCosts[node.local] < Unreachable)
+        {
+            relax(goalNode, cost + goalCosts[node.local], entry.node, goal);
+        }
+    }
+    if (!found)
+    {
+        return false;
+    }
+
+    // Абстрактный путь уточняется до клеток: переход границы - один ход, участок внутри кластера -
+    // прямой путь, если он открыт, иначе поиск в кластере
+    m_route.clear();
+    for (int node = goalNode; node != startNode; node = m_parent[node])
+    {
+        m_route.push_back(node);
+    }
+    path.push_back(start);
+    for (auto it = m_route.rbegin(); it != m_route.rend(); ++it)
+    {
+        sf::Vector2i from = path.back();
+        sf::Vector2i to = *it == goalNode ? goal : sf::Vector2i(m_nodes[*it].x, m_nodes[*it].y);
+        if (to == from)
+            continue;
+
+        int cluster = clusterOf(from.x, from.y);
+        if (cluster != clusterOf(to.x, to.y))
+        {
+            path.push_back(to);
+            continue;
+        }
+        if (followStraight(from, to, &path))
+            continue;
+        m_clusterSearch->load(m_grid, getClusterBounds(cluster));
+        m_clusterSearch->search(from.x, from.y, to.x, to.y);
+        m_clusterSearch->appendPath(to.x, to.y, path);
+    }
+    return true;
+}
+
+// Получить количество узлов абстрактного графа
+int HierarchicalPathfinder::getNodeCount() const
+{
+    return static_cast<int>(m_nodes.size() - m_freeNodes.size());
+}
+
+// Получить количество кластеров, перестроенных с создания
+std::uint64_t HierarchicalPathfinder::getRebuiltClusterCount() const
+{
+    return m_rebuiltClusterCount;
+}
+
+// Получить индекс кластера клетки
+int HierarchicalPathfinder::clusterOf(int x, int y) const
+{
+    return (y / ClusterSize) * m_clustersX + x / ClusterSize;
+}
+
+// Получить прямоугольник кластера в клетках
+sf::IntRect HierarchicalPathfinder::getClusterBounds(int cluster) const
+{
+    int left = (cluster % m_clustersX) * ClusterSize;
+    int top = (cluster / m_clustersX) * ClusterSize;
+    return sf::IntRect(left, top, std::min(ClusterSize, m_grid.getWidth() - left), std::min(ClusterSize, m_grid.getHeight() - top));
+}
+
+// Посчитать расстояния от клетки до узлов её кластера или взять сохранённые, если кластер не перестраивался
+const std::vector<float>& HierarchicalPathfinder::fillCluster(ClusterFill& fill, sf::Vector2i cell)
+{
+    const int cluster = clusterOf(cell.x, cell.y);
+    const Cluster& target = m_clusters[cluster];
+    if (fill.cluster == cluster && fill.cell == cell && fill.version == target.version)
+    {
+        return fill.costs;
+    }
+    fill.cell = cell;
+    fill.cluster = cluster;
+    fill.version = target.version;
+    fill.costs.resize(target.nodes.size());
+
+    // На открытом месте до узлов ведут прямые пути, и поиск по кластеру не нужен
+    bool straight = true;
+    for (std::size_t i = 0; i < target.nodes.size() && straight; ++i)
+    {
+        const Node& node = m_nodes[target.nodes[i]];
+        straight = followStraight(cell, sf::Vector2i(node.x, node.y), nullptr);
+        fill.costs[i] = octileDistance(cell.x, cell.y, node.x, node.y);
+    }
+    if (straight)
+    {
+        return fill.costs;
+    }
+
+    m_clusterSearch->load(m_grid, getClusterBounds(cluster));
+    m_clusterSearch->fill(cell.x, cell.y);
+    for (std::size_t i = 0; i < target.nodes.size(); ++i)
+    {
+        const Node& node = m_nodes[target.nodes[i]];
+        fill.costs[i] = m_clusterSearch->distance(node.x, node.y);
+    }
+    return fill.costs;
+}
+
+// Улучшить путь до узла абстрактного графа
+void HierarchicalPathfinder::relax(int node, float cost, int parent, sf::Vector2i goal)
+{
+    if (m_visit[node] == m_search && m_cost[node] <= cost)
+    {
+        return;
+    }
+    m_visit[node] = m_search;
+    m_cost[node] = cost;
+    m_parent[node] = parent;
+
+    // У цели оценка остатка нулевая
+    float remaining = node < static_cast<int>(m_nodes.size()) ? octileDistance(m_nodes[node].x, m_nodes[node].y, goal.x, goal.y) : 0.0f;
+    m_open.push_back({ cost + remaining, cost, node });
+    std::push_heap(m_open.begin(), m_open.end());
+}
+
+// Проверить, что из from в to есть прямой путь длиной в октильное расстояние, и дописать его в path (если не nullptr)
+bool HierarchicalPathfinder::followStraight(sf::Vector2i from, sf::Vector2i to, std::vector<sf::Vector2i>* path) const
+{
+    bool diagonalFirst;
+    if (!m_grid.hasStraightPath(from.x, from.y, to.x, to.y, diagonalFirst))
+    {
+        return false;
+    }
+    if (path)
+    {
+        // Путь идёт через угол: от from по диагонали (или по прямой) до угла, оттуда по прямой (или по диагонали) до to.
+        // На каждом отрезке ход к его концу - знаки разностей координат
+        const int diagonal = std::min(std::abs(to.x - from.x), std::abs(to.y - from.y));
+        const sf::Vector2i diagonalStep((to.x > from.x) - (to.x < from.x), (to.y > from.y) - (to.y < from.y));
+        const sf::Vector2i corner = diagonalFirst ? from + diagonalStep * diagonal : to - diagonalStep * diagonal;
+        sf::Vector2i cell = from;
+        for (sf::Vector2i end : { corner, to })
+        {
+            while (cell != end)
+            {
+                cell += sf::Vector2i((end.x > cell.x) - (end.x < cell.x), (end.y > cell.y) - (end.y < cell.y));
+                path->push_back(cell);
+            }
+        }
+    }
+    return true;
+}
+
+// Пометить границу для перестройки (side: 0 - восточная граница кластера, 1 - южная)
+void HierarchicalPathfinder::markBorder(int cluster, int side)
+{
+    int border = cluster * 2 + side;
+    if (!m_borderDirty[border])
+    {
+        m_borderDirty[border] = 1;
+        m_dirtyBorders.push_back(border);
+    }
+}
+
+// Пометить кластер для перестройки
+void HierarchicalPathfinder::markCluster(int cluster)
+{
+    if (!m_clusterDirty[cluster])
+    {
+        m_clusterDirty[cluster] = 1;
+        m_dirtyClusters.push_back(cluster);
+    }
+}
+
+// Найти входы на границе и создать их узлы
+void HierarchicalPathfinder::buildBorder(int cluster, int side)
+{
+    std::vector<int>& nodes = m_borders[side][cluster];
+    for (int node : nodes)
+    {
+        m_nodes[node].cluster = -1;
+        m_freeNodes.push_back(node);
+    }
+    nodes.clear();
+
+    // Граница - линия клеток кластера, за каждой из которых лежит клетка соседа (шаг step)
+    sf::IntRect bounds = getClusterBounds(cluster);
+    int neighbour;
+    int length;
+    sf::Vector2i first;
+    sf::Vector2i along;
+    sf::Vector2i across;
+    if (side == 0)
+    {
+        if (cluster % m_clustersX == m_clustersX - 1)
+            return;
+        neighbour = cluster + 1;
+        length = bounds.height;
+        first = sf::Vector2i(bounds.left + bounds.width - 1, bounds.top);
+        along = sf::Vector2i(0, 1);
+        across = sf::Vector2i(1, 0);
+    }
+    else
+    {
+        if (cluster / m_clustersX == m_clustersY - 1)
+            return;
+        neighbour = cluster + m_clustersX;
+        length = bounds.width;
+        first = sf::Vector2i(bounds.left, bounds.top + bounds.height - 1);
+        along = sf::Vector2i(1, 0);
+        across = sf::Vector2i(0, 1);
+    }
+    markCluster(cluster);
+    markCluster(neighbour);
+
+    // Вход - непрерывный отрезок границы, открытый с обеих сторон
+    auto addEntrance = [&](int i)
+    {
+        sf::Vector2i inside = first + along * i;
+        sf::Vector2i outside = inside + across;
+        int own = allocateNode(inside.x, inside.y);
+        int other = allocateNode(outside.x, outside.y);
+        m_nodes[own].twin = other;
+        m_nodes[other].twin = own;
+        nodes.push_back(own);
+        nodes.push_back(other);
+    };
+    int runStart = -1;
+    for (int i = 0; i <= length; ++i)
+    {
+        sf::Vector2i inside = first + along * i;
+        if (i < length && m_grid.isPassable(inside.x, inside.y) && m_grid.isPassable(inside.x + across.x, inside.y + across.y))
+        {
+            if (runStart < 0)
+                runStart = i;
+            continue;
+        }
+        if (runStart < 0)
+            continue;
+
+        int runLength = i - runStart;
+        if (runLength < EntranceSplitLength)
+        {
+            addEntrance(runStart + runLength / 2);
+        }
+        else
+        {
+            addEntrance(runStart);
+            addEntrance(i - 1);
+        }
+        runStart = -1;
+    }
+}
+
+// Собрать узлы кластера с его четырёх границ
+void HierarchicalPathfinder::gatherNodes(int cluster)
+{
+    // На своих границах (восточной и южной) узлы кластера - первые в парах, на границах соседей - вторые
+    std::vector<int>& nodes = m_clusters[cluster].nodes;
+    nodes.clear();
+    auto take = [&nodes](const std::vector<int>& border, std::size_t offset)
+    {
+        for (std::size_t i = offset; i < border.size(); i += 2)
+        {
+            nodes.push_back(border[i]);
+        }
+    };
+    take(m_borders[0][cluster], 0);
+    take(m_borders[1][cluster], 0);
+    if (cluster % m_clustersX > 0)
+        take(m_borders[0][cluster - 1], 1);
+    if (cluster / m_clustersX > 0)
+        take(m_borders[1][cluster - m_clustersX], 1);
+
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+    {
+        m_nodes[nodes[i]].cluster = cluster;
+        m_nodes[nodes[i]].local = static_cast<int>(i);
+    }
+}
+
+// Посчитать расстояния между узлами кластера
+void HierarchicalPathfinder::computeCosts(int cluster, ClusterSearch& search)
+{
+    Cluster& target = m_clusters[cluster];
+    std::size_t count = target.nodes.size();
+    target.costs.assign(count * count, Unreachable);
+
+    // Расстояния симметричны: один поиск от узла i даёт строку и столбец i
+    search.load(m_grid, getClusterBounds(cluster));
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const Node& from = m_nodes[target.nodes[i]];
+        target.costs[i * count + i] = 0.0f;
+        if (i + 1 == count)
+            break;
+        search.fill(from.x, from.y);
+        for (std::size_t j = i + 1; j < count; ++j)
+        {
+            const Node& to = m_nodes[target.nodes[j]];
+            float cost = search.distance(to.x, to.y);
+            target.costs[i * count + j] = cost;
+            target.costs[j * count + i] = cost;
+        }
+    }
+}
+
+// Занять свободный узел
+int HierarchicalPathfinder::allocateNode(int x, int y)
+{
+    int node;
+    if (!m_freeNodes.empty())
+    {
+        node = m_freeNodes.back();
+        m_freeNodes.pop_back();
+    }
+    else
+    {
+        node = static_cast<int>(m_nodes.size());
+        m_nodes.push_back(Node());
+    }
+    m_nodes[node].x = x;
+    m_nodes[node].y = y;
+    m_nodes[node].cluster = clusterOf(x, y);
+    m_nodes[node].twin = -1;
+    return node;
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "PathGrid.h"
+
+class ThreadPool;
+
+// Иерархический поиск пути (HPA*) по карте проходимости с ходами в 8 сторон
+// (по диагонали - только если обе соседние по сторонам клетки проходимы, цена sqrt(2)).
+// Карта делится на кластеры ClusterSize x ClusterSize (совпадают с чанками мира).
+// На границах соседних кластеров заранее выбираются входы, а внутри кластера считаются
+// расстояния между его входами: получается абстрактный граф, в котором путь ищется A*,
+// после чего уточняется до клеток поиском только внутри кластеров пути.
+// При изменении клеток перестраиваются лишь затронутые кластеры (и соседи по изменённой
+// границе), причём лениво - перед следующим поиском.
+// Поиск по кластеру и расстояния от начала и цели до узлов их кластеров сохраняются между запросами;
+// параллельно с A* граф обходится от цели, и если цель в отдельной области, поиск кончается,
+// не перебирая всю область начала
+class HierarchicalPathfinder
+{
+public:
+    static constexpr int ClusterSize = 32; // Размер кластера в клетках
+
+    // Построить абстрактный граф по карте проходимости (pool - пул потоков для кластеров или nullptr)
+    explicit HierarchicalPathfinder(PathGrid grid, ThreadPool* pool = nullptr);
+    ~HierarchicalPathfinder();
+
+    // Получить карту проходимости
+    const PathGrid& getGrid() const;
+    // Изменить проходимость клетки; затронутые кластеры перестраиваются перед следующим поиском
+    void setPassable(int x, int y, bool passable);
+    // Перестроить изменённые кластеры сейчас (pool - пул потоков для кластеров или nullptr)
+    void rebuild(ThreadPool* pool = nullptr);
+
+    // Найти путь из start в goal: path получает клетки пути от start до goal включительно.
+    // false (и пустой path), если пути нет или одна из клеток непроходима
+    bool findPath(sf::Vector2i start, sf::Vector2i goal, std::vector<sf::Vector2i>& path);
+
+    // Получить количество узлов абстрактного графа
+    int getNodeCount() const;
+    // Получить количество кластеров, перестроенных с создания (для оценки стоимости изменений)
+    std::uint64_t getRebuiltClusterCount() const;
+
+private:
+    class ClusterSearch;
+
+    // Узел абстрактного графа: клетка входа на границе кластера
+    struct Node
+    {
+        int x = 0;        // Столбец клетки
+        int y = 0;        // Строка клетки
+        int cluster = -1; // Кластер клетки (-1 - узел свободен)
+        int local = 0;    // Номер узла среди узлов кластера
+        int twin = -1;    // Узел по другую сторону границы (переход ценой 1)
+    };
+
+    // Кластер: его узлы и расстояния между ними внутри кластера
+    struct Cluster
+    {
+        std::vector<int> nodes;    // Узлы кластера
+        std::vector<float> costs;  // Расстояния nodes.size() x nodes.size() (бесконечность - нет пути в кластере)
+        std::uint64_t version = 0; // Номер последней перестройки кластера
+    };
+
+    // Расстояния от клетки до узлов её кластера, сохранённые до перестройки кластера
+    struct ClusterFill
+    {
+        sf::Vector2i cell;         // Клетка, от которой считались расстояния
+        int cluster = -1;          // Кластер клетки (-1 - расстояний нет)
+        std::uint64_t version = 0; // Номер перестройки кластера, при котором они считались
+        std::vector<float> costs;  // Расстояния до узлов кластера (по их номерам в кластере)
+    };
+
+    // Элемент открытого списка A*
+    struct OpenEntry
+    {
+        float priority; // Оценка длины пути через узел
+        float cost;     // Длина пути до узла
+        int node;       // Узел
+
+        // Наверху кучи - наименьшая оценка, при равенстве - узел дальше от начала
+        bool operator<(const OpenEntry& other) const
+        {
+            return priority > other.priority || (priority == other.priority && cost < other.cost);
+        }
+    };
+
+    // Получить индекс кластера клетки
+    int clusterOf(int x, int y) const;
+    // Получить прямоугольник кластера в клетках
+    sf::IntRect getClusterBounds(int cluster) const;
+    // Посчитать расстояния от клетки до узлов её кластера или взять сохранённые, если кластер не перестраивался
+    const std::vector<float>& fillCluster(ClusterFill& fill, sf::Vector2i cell);
+    // Улучшить путь до узла абстрактного графа
+    void relax(int node, float cost, int parent, sf::Vector2i goal);
+    // Проверить, что из from в to есть прямой путь длиной в октильное расстояние, и дописать его в path (если не nullptr)
+    bool followStraight(sf::Vector2i from, sf::Vector2i to, std::vector<sf::Vector2i>* path) const;
+    // Пометить границу для перестройки (side: 0 - восточная граница кластера, 1 - южная)
+    void markBorder(int cluster, int side);
+    // Пометить кластер для перестройки
+    void markCluster(int cluster);
+    // Найти входы на границе и создать их узлы
+    void buildBorder(int cluster, int side);
+    // Собрать узлы кластера с его четырёх границ
+    void gatherNodes(int cluster);
+    // Посчитать расстояния между узлами кластера
+    void computeCosts(int cluster, ClusterSearch& search);
+    // Занять свободный узел
+    int allocateNode(int x, int y);
+
+    PathGrid m_grid;                              // Карта проходимости
+    int m_clustersX;                              // Кластеров по горизонтали
+    int m_clustersY;                              // Кластеров по вертикали
+    std::vector<Cluster> m_clusters;              // Кластеры (построчно)
+    std::vector<std::vector<int>> m_borders[2];   // Узлы входов границ кластеров парами (свой, соседа): восточных и южных
+    std::vector<Node> m_nodes;                    // Узлы абстрактного графа
+    std::vector<int> m_freeNodes;                 // Свободные узлы
+    std::vector<int> m_dirtyBorders;              // Границы для перестройки (cluster * 2 + side)
+    std::vector<int> m_dirtyClusters;             // Кластеры для перестройки
+    std::vector<std::uint8_t> m_borderDirty;      // Граница уже помечена (по cluster * 2 + side)
+    std::vector<std::uint8_t> m_clusterDirty;     // Кластер уже помечен
+    std::uint64_t m_rebuiltClusterCount;          // Перестроено кластеров с создания
+
+    // Память поиска по абстрактному графу, переиспользуемая между запросами
+    std::vector<float> m_cost;                    // Лучшая найденная длина пути до узла
+    std::vector<int> m_parent;                    // Предыдущий узел пути
+    std::vector<std::uint32_t> m_visit;           // Номер поиска, в котором узел достигнут
+    std::uint32_t m_search;                       // Номер текущего поиска
+    std::vector<OpenEntry> m_open;                // Открытый список (двоичная куча)
+    std::vector<std::uint32_t> m_flooded;         // Номер поиска, в котором узел достигнут обходом от цели
+    std::vector<int> m_flood;                     // Очередь обхода от цели
+    ClusterFill m_startFill;                      // Расстояния от начала до узлов его кластера
+    ClusterFill m_goalFill;                       // Расстояния от цели до узлов её кластера
+    std::unique_ptr<ClusterSearch> m_clusterSearch; // Поиск по клеткам кластера
+    std::vector<int> m_route;                     // Узлы найденного абстрактного пути
+};
@@ -0,0 +1,493 @@
+#include "JumpPointSearch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+    const float DiagonalCost = 1.41421356f; // Цена хода по диагонали
+    const int InitialTableBits = 12;        // Начальный размер таблицы точек - 2^12
+    const float StraightPathLength = 64.0f; // До этой длины прямой путь проверяется раньше поиска
+
+    // Оценка длины пути с ходами в 8 сторон (октильное расстояние)
+    float octileDistance(int x0, int y0, int x1, int y1)
+    {
+        int dx = std::abs(x1 - x0);
+        int dy = std::abs(y1 - y0);
+        return static_cast<float>(std::max(dx, dy)) + (DiagonalCost - 1.0f) * static_cast<float>(std::min(dx, dy));
+    }
+
+    // Знак числа: -1, 0 или 1
+    int sign(int value)
+    {
+        return (value > 0) - (value < 0);
+    }
+
+    // Биты клеток линии side, у которых проходима сама клетка, а предыдущая по ходу step - нет
+    std::uint64_t openingBits(const std::uint64_t* side, int words, int w, int step)
+    {
+        if (side == nullptr)
+            return 0;
+        std::uint64_t word = side[w];
+        std::uint64_t previous;
+        if (step > 0)
+            previous = (word << 1) | (w > 0 ? side[w - 1] >> 63 : 0);
+        else
+            previous = (word >> 1) | (w + 1 < words ? side[w + 1] << 63 : 0);
+        return word & ~previous;
+    }
+
+    // Развернуть в клетки отрезки (прямые или диагональные) между соседними точками path на месте,
+    // с конца, чтобы клетки не затирали ещё не прочитанные точки (соседние точки различны)
+    void expandSegments(std::vector<sf::Vector2i>& path)
+    {
+        const std::size_t points = path.size();
+        std::size_t length = 1;
+        for (std::size_t i = 1; i < points; ++i)
+        {
+            length += std::max(std::abs(path[i].x - path[i - 1].x), std::abs(path[i].y - path[i - 1].y));
+        }
+        path.resize(length);
+        std::size_t out = length - 1;
+        for (std::size_t i = points - 1; i > 0; --i)
+        {
+            sf::Vector2i to = path[i];
+            sf::Vector2i from = path[i - 1];
+            sf::Vector2i step(sign(to.x - from.x), sign(to.y - from.y));
+            for (sf::Vector2i cell = to; cell != from; cell -= step)
+            {
+                path[out--] = cell;
+            }
+        }
+    }
+}
+
+// Подготовить поиск по карте проходимости
+JumpPointSearch::JumpPointSearch(PathGrid grid)
+    : m_grid(std::move(grid))
+    , m_goal()
+    , m_tableShift(32 - InitialTableBits)
+    , m_pointCount(0)
+    , m_search(0)
+    , m_expandedCount(0)
+{
+    if (static_cast<std::uint64_t>(m_grid.getWidth()) * m_grid.getHeight() > std::numeric_limits<std::uint32_t>::max())
+    {
+        throw std::invalid_argument("Path grid is too large for jump point search");
+    }
+    m_points.resize(std::size_t(1) << InitialTableBits);
+
+    const int width = m_grid.getWidth();
+    const int height = m_grid.getHeight();
+    m_rowStops.reset(height, width);
+    for (int y = 0; y < height; ++y)
+    {
+        const std::uint64_t* before = y > 0 ? m_grid.row(y - 1) : nullptr;
+        const std::uint64_t* after = y + 1 < height ? m_grid.row(y + 1) : nullptr;
+        for (int w = 0; w < m_rowStops.words; ++w)
+            m_rowStops.refresh(y, w, m_grid.row(y), before, after);
+    }
+    m_columnStops.reset(width, height);
+    for (int x = 0; x < width; ++x)
+    {
+        const std::uint64_t* before = x > 0 ? m_grid.column(x - 1) : nullptr;
+        const std::uint64_t* after = x + 1 < width ? m_grid.column(x + 1) : nullptr;
+        for (int w = 0; w < m_columnStops.words; ++w)
+            m_columnStops.refresh(x, w, m_grid.column(x), before, after);
+    }
+}
+
+// Получить карту проходимости
+const PathGrid& JumpPointSearch::getGrid() const
+{
+    return m_grid;
+}
+
+// Изменить проходимость клетки
+void JumpPointSearch::setPassable(int x, int y, bool passable)
+{
+    m_grid.setPassable(x, y, passable);
+    refreshStops(x, y);
+}
+
+// Найти кратчайший путь из start в goal
+bool JumpPointSearch::findPath(sf::Vector2i start, sf::Vector2i goal, std::vector<sf::Vector2i>& path)
+{
+    path.clear();
+    m_expandedCount = 0;
+    if (!m_grid.isPassable(start.x, start.y) || !m_grid.isPassable(goal.x, goal.y))
+    {
+        return false;
+    }
+    if (start == goal)
+    {
+        path.push_back(start);
+        return true;
+    }
+
+    // Короткий путь, открытый по диагонали и по прямой, кратчайший: он строится без поиска, дорогого
+    // по сравнению с самим путём. Если прямой путь закрыт, его проверка стоит не больше StraightPathLength клеток
+    bool diagonalFirst;
+    if (octileDistance(start.x, start.y, goal.x, goal.y) <= StraightPathLength
+        && m_grid.hasStraightPath(start.x, start.y, goal.x, goal.y, diagonalFirst))
+    {
+        const int diagonal = std::min(std::abs(goal.x - start.x), std::abs(goal.y - start.y));
+        const sf::Vector2i diagonalStep(sign(goal.x - start.x), sign(goal.y - start.y));
+        const sf::Vector2i corner = diagonalFirst ? start + diagonalStep * diagonal : goal - diagonalStep * diagonal;
+        path.push_back(start);
+        if (corner != start && corner != goal)
+            path.push_back(corner);
+        path.push_back(goal);
+        expandSegments(path);
+        return true;
+    }
+
+    if (++m_search == 0)
+    {
+        for (Point& point : m_points)
+            point.search = 0;
+        m_search = 1;
+    }
+    m_pointCount = 0;
+    m_open.clear();
+    m_goal = goal;
+
+    const std::uint32_t width = static_cast<std::uint32_t>(m_grid.getWidth());
+    const std::uint32_t startCell = static_cast<std::uint32_t>(start.y) * width + start.x;
+    const std::uint32_t goalCell = static_cast<std::uint32_t>(goal.y) * width + goal.x;
+    Point& origin = visit(startCell);
+    origin.cost = 0.0f;
+    origin.parent = startCell;
+    m_open.push_back({ octileDistance(start.x, start.y, goal.x, goal.y), 0.0f, startCell });
+
+    while (!m_open.empty())
+    {
+        std::pop_heap(m_open.begin(), m_open.end());
+        OpenEntry entry = m_open.back();
+        m_open.pop_back();
+
+        // Устаревшая запись: точка уже раскрыта с путём не длиннее
+        Point& point = visit(entry.cell);
+        if (point.closed || entry.cost > point.cost)
+            continue;
+        point.closed = true;
+        ++m_expandedCount;
+        if (entry.cell == goalCell)
+        {
+            buildPath(goalCell, path);
+            return true;
+        }
+
+        // Таблица может вырасти при добавлении точек, поэтому нужное из point читается заранее
+        const float cost = point.cost;
+        const int x = static_cast<int>(entry.cell % width);
+        const int y = static_cast<int>(entry.cell / width);
+        const int dx = sign(x - static_cast<int>(point.parent % width));
+        const int dy = sign(y - static_cast<int>(point.parent / width));
+
+        // Направления, в которых кратчайший путь может продолжиться после хода (dx, dy).
+        // Повороты на 90 градусов от прямого хода нужны без учёта препятствий: без срезания углов
+        // путь огибает угол только через клетку рядом с ним
+        sf::Vector2i directions[8];
+        int count = 0;
+        if (dx == 0 && dy == 0)
+        {
+            for (int ny = -1; ny <= 1; ++ny)
+                for (int nx = -1; nx <= 1; ++nx)
+                    if (nx != 0 || ny != 0)
+                        directions[count++] = { nx, ny };
+        }
+        else if (dx != 0 && dy != 0)
+        {
+            directions[count++] = { dx, 0 };
+            directions[count++] = { 0, dy };
+            directions[count++] = { dx, dy };
+        }
+        else if (dx != 0)
+        {
+            directions[count++] = { dx, 0 };
+            directions[count++] = { dx, 1 };
+            directions[count++] = { dx, -1 };
+            directions[count++] = { 0, 1 };
+            directions[count++] = { 0, -1 };
+        }
+        else
+        {
+            directions[count++] = { 0, dy };
+            directions[count++] = { 1, dy };
+            directions[count++] = { -1, dy };
+            directions[count++] = { 1, 0 };
+            directions[count++] = { -1, 0 };
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            int jumpX;
+            int jumpY;
+            if (jump(x, y, directions[i].x, directions[i].y, jumpX, jumpY))
+            {
+                relax(jumpX, jumpY, cost + octileDistance(x, y, jumpX, jumpY), entry.cell);
+            }
+        }
+    }
+    return false;
+}
+
+// Получить количество точек прыжка, раскрытых последним поиском
+int JumpPointSearch::getExpandedCount() const
+{
+    return m_expandedCount;
+}
+
+// Выделить биты lineCount линий длиной length
+void JumpPointSearch::StopLines::reset(int lineCount, int length)
+{
+    words = (length + 63) / 64;
+    summaryWords = (words + 63) / 64;
+    for (int d = 0; d < 2; ++d)
+    {
+        bits[d].assign(static_cast<std::size_t>(words) * lineCount, 0);
+        summary[d].assign(static_cast<std::size_t>(summaryWords) * lineCount, 0);
+    }
+}
+
+// Пересчитать слово w линии index по проходимости линии и соседних
+void JumpPointSearch::StopLines::refresh(int index, int w, const std::uint64_t* line, const std::uint64_t* before, const std::uint64_t* after)
+{
+    for (int d = 0; d < 2; ++d)
+    {
+        const int step = d == 0 ? 1 : -1;
+        std::uint64_t stop = ~line[w] | openingBits(before, words, w, step) | openingBits(after, words, w, step);
+        bits[d][static_cast<std::size_t>(index) * words + w] = stop;
+
+        std::uint64_t& flags = summary[d][static_cast<std::size_t>(index) * summaryWords + (w >> 6)];
+        std::uint64_t flag = 1ull << (w & 63);
+        if (stop != 0)
+            flags |= flag;
+        else
+            flags &= ~flag;
+    }
+}
+
+// Прыгнуть по линии index от клетки from в направлении step
+int JumpPointSearch::StopLines::scan(int index, int length, int from, int step, int target, const std::uint64_t* line) const
+{
+    if (from < 0 || from >= length)
+    {
+        return -1;
+    }
+
+    // Ближайшая остановка: сначала в слове клетки from, затем в первом слове с остановкой по сводке
+    int stop = -1;
+    if (step > 0)
+    {
+        const std::uint64_t* stops = bits[0].data() + static_cast<std::size_t>(index) * words;
+        const std::uint64_t* flags = summary[0].data() + static_cast<std::size_t>(index) * summaryWords;
+        int w = from >> 6;
+        std::uint64_t word = stops[w] & (~0ull << (from & 63));
+        if (word == 0 && ++w < words)
+        {
+            int s = w >> 6;
+            std::uint64_t flag = flags[s] & (~0ull << (w & 63));
+            while (flag == 0 && ++s < summaryWords)
+                flag = flags[s];
+            if (flag != 0)
+            {
+                w = s * 64 + countTrailingZeros(flag);
+                word = stops[w];
+            }
+        }
+        if (word != 0)
+            stop = w * 64 + countTrailingZeros(word);
+        // Цель до остановки достижима: все клетки между ними проходимы
+        if (target >= from && (stop < 0 || target <= stop))
+            return target;
+    }
+    else
+    {
+        const std::uint64_t* stops = bits[1].data() + static_cast<std::size_t>(index) * words;
+        const std::uint64_t* flags = summary[1].data() + static_cast<std::size_t>(index) * summaryWords;
+        int w = from >> 6;
+        std::uint64_t word = stops[w] & (~0ull >> (63 - (from & 63)));
+        if (word == 0 && --w >= 0)
+        {
+            int s = w >> 6;
+            std::uint64_t flag = flags[s] & (~0ull >> (63 - (w & 63)));
+            while (flag == 0 && --s >= 0)
+                flag = flags[s];
+            if (flag != 0)
+            {
+                w = s * 64 + 63 - countLeadingZeros(flag);
+                word = stops[w];
+            }
+        }
+        if (word != 0)
+            stop = w * 64 + 63 - countLeadingZeros(word);
+        if (target >= 0 && target <= from && target >= stop)
+            return target;
+    }
+    return stop >= 0 && (line[stop >> 6] >> (stop & 63) & 1) != 0 ? stop : -1;
+}
+
+// Пересчитать биты остановки вокруг клетки (x, y): клетка входит в свою строку и столбец,
+// а как соседняя - в строки и столбцы по обе стороны, где влияет на остановки в себе и следующей клетке
+void JumpPointSearch::refreshStops(int x, int y)
+{
+    const int width = m_grid.getWidth();
+    const int height = m_grid.getHeight();
+    for (int row = std::max(y - 1, 0); row <= std::min(y + 1, height - 1); ++row)
+    {
+        const std::uint64_t* before = row > 0 ? m_grid.row(row - 1) : nullptr;
+        const std::uint64_t* after = row + 1 < height ? m_grid.row(row + 1) : nullptr;
+        for (int w = std::max(x - 1, 0) >> 6; w <= std::min(x + 1, width - 1) >> 6; ++w)
+            m_rowStops.refresh(row, w, m_grid.row(row), before, after);
+    }
+    for (int column = std::max(x - 1, 0); column <= std::min(x + 1, width - 1); ++column)
+    {
+        const std::uint64_t* before = column > 0 ? m_grid.column(column - 1) : nullptr;
+        const std::uint64_t* after = column + 1 < width ? m_grid.column(column + 1) : nullptr;
+        for (int w = std::max(y - 1, 0) >> 6; w <= std::min(y + 1, height - 1) >> 6; ++w)
+            m_columnStops.refresh(column, w, m_grid.column(column), before, after);
+    }
+}
+
+// Прыгнуть из (x, y) в направлении (dx, dy)
+bool JumpPointSearch::jump(int x, int y, int dx, int dy, int& jumpX, int& jumpY) const
+{
+    if (dy == 0)
+    {
+        jumpX = jumpHorizontal(x + dx, y, dx);
+        jumpY = y;
+        return jumpX >= 0;
+    }
+    if (dx == 0)
+    {
+        jumpX = x;
+        jumpY = jumpVertical(x, y + dy, dy);
+        return jumpY >= 0;
+    }
+    // Без срезания углов: обе клетки по сторонам диагонального хода должны быть проходимы
+    if (!m_grid.isPassable(x + dx, y) || !m_grid.isPassable(x, y + dy))
+    {
+        return false;
+    }
+    jumpX = x + dx;
+    jumpY = y + dy;
+    return jumpDiagonal(jumpX, jumpY, dx, dy);
+}
+
+// Прыгнуть по строке y начиная с клетки x в направлении dx
+int JumpPointSearch::jumpHorizontal(int x, int y, int dx) const
+{
+    return m_rowStops.scan(y, m_grid.getWidth(), x, dx, m_goal.y == y ? m_goal.x : -1, m_grid.row(y));
+}
+
+// Прыгнуть по столбцу x начиная с клетки y в направлении dy
+int JumpPointSearch::jumpVertical(int x, int y, int dy) const
+{
+    return m_columnStops.scan(x, m_grid.getHeight(), y, dy, m_goal.x == x ? m_goal.y : -1, m_grid.column(x));
+}
+
+// Прыгнуть по диагонали начиная с клетки (x, y).
+// Клетка диагонали - точка прыжка, если из неё находится точка прыжка по одной из двух её прямых
+bool JumpPointSearch::jumpDiagonal(int& x, int& y, int dx, int dy) const
+{
+    while (m_grid.isPassable(x, y))
+    {
+        if ((x == m_goal.x && y == m_goal.y) || jumpHorizontal(x + dx, y, dx) >= 0 || jumpVertical(x, y + dy, dy) >= 0)
+        {
+            return true;
+        }
+        if (!m_grid.isPassable(x + dx, y) || !m_grid.isPassable(x, y + dy))
+        {
+            return false;
+        }
+        x += dx;
+        y += dy;
+    }
+    return false;
+}
+
+// Найти точку клетки в таблице, добавив её, если поиск ещё не достигал клетки
+JumpPointSearch::Point& JumpPointSearch::visit(std::uint32_t cell)
+{
+    // Заполненность держится не выше половины, чтобы цепочки проб оставались короткими
+    if ((m_pointCount + 1) * 2 > m_points.size())
+    {
+        growTable();
+    }
+    const std::size_t mask = m_points.size() - 1;
+    std::size_t index = (cell * 2654435769u) >> m_tableShift;
+    while (m_points[index].search == m_search)
+    {
+        if (m_points[index].cell == cell)
+            return m_points[index];
+        index = (index + 1) & mask;
+    }
+
+    Point& point = m_points[index];
+    point.cell = cell;
+    point.search = m_search;
+    point.cost = std::numeric_limits<float>::infinity();
+    point.parent = cell;
+    point.closed = false;
+    ++m_pointCount;
+    return point;
+}
+
+// Удвоить хеш-таблицу точек
+void JumpPointSearch::growTable()
+{
+    std::vector<Point> old(m_points.size() * 2);
+    old.swap(m_points);
+    --m_tableShift;
+
+    const std::size_t mask = m_points.size() - 1;
+    for (const Point& point : old)
+    {
+        if (point.search != m_search)
+            continue;
+        std::size_t index = (point.cell * 2654435769u) >> m_tableShift;
+        while (m_points[index].search == m_search)
+        {
+            index = (index + 1) & mask;
+        }
+        m_points[index] = point;
+    }
+}
+
+// Улучшить путь до точки прыжка
+void JumpPointSearch::relax(int x, int y, float cost, std::uint32_t parent)
+{
+    std::uint32_t cell = static_cast<std::uint32_t>(y) * static_cast<std::uint32_t>(m_grid.getWidth()) + x;
+    Point& point = visit(cell);
+    if (point.closed || cost >= point.cost)
+    {
+        return;
+    }
+    point.cost = cost;
+    point.parent = parent;
+    m_open.push_back({ cost + octileDistance(x, y, m_goal.x, m_goal.y), cost, cell });
+    std::push_heap(m_open.begin(), m_open.end());
+}
+
+// Собрать клетки пути от начала до goal по цепочке точек прыжка
+void JumpPointSearch::buildPath(std::uint32_t goal, std::vector<sf::Vector2i>& path)
+{
+    const std::uint32_t width = static_cast<std::uint32_t>(m_grid.getWidth());
+    for (std::uint32_t cell = goal;; )
+    {
+        path.emplace_back(static_cast<int>(cell % width), static_cast<int>(cell / width));
+        std::uint32_t parent = visit(cell).parent;
+        if (parent == cell)
+            break;
+        cell = parent;
+    }
+    std::reverse(path.begin(), path.end());
+
+    // Соседние точки прыжка соединены прямым или диагональным отрезком
+    expandSegments(path);
+}
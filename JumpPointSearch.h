@@ -0,0 +1,112 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "PathGrid.h"
+
+// Поиск пути A* с прыжками (Jump Point Search) по карте проходимости с ходами в 8 сторон
+// (по диагонали - только если обе соседние по сторонам клетки проходимы, цена sqrt(2)), как у HierarchicalPathfinder.
+// На карте с одинаковой ценой клеток большинство клеток пути промежуточные: поиск пропускает их,
+// прыгая по прямой до клетки с вынужденным соседом, и в открытый список попадают только такие точки прыжка.
+// Для каждой строки и столбца заранее хранятся биты клеток, на которых прыжок останавливается, и сводка
+// с битом на каждое их слово: прыжок находит ближайшую остановку подсчётом нулевых бит в сводке и слове,
+// не проходя клетки по одной даже на широких открытых строках неба.
+// Память поиска (хеш-таблица точек и куча) переиспользуется между запросами и растёт только на больших путях.
+// Короткий путь, открытый по диагонали и по прямой, строится без поиска
+class JumpPointSearch
+{
+public:
+    // Подготовить поиск по карте проходимости (исключение, если у карты не меньше 2^32 клеток)
+    explicit JumpPointSearch(PathGrid grid);
+
+    // Получить карту проходимости
+    const PathGrid& getGrid() const;
+    // Изменить проходимость клетки (с битами остановки соседних строк и столбцов)
+    void setPassable(int x, int y, bool passable);
+
+    // Найти кратчайший путь из start в goal: path получает клетки пути от start до goal включительно.
+    // false (и пустой path), если пути нет или одна из клеток непроходима
+    bool findPath(sf::Vector2i start, sf::Vector2i goal, std::vector<sf::Vector2i>& path);
+
+    // Получить количество точек прыжка, раскрытых последним поиском
+    int getExpandedCount() const;
+
+private:
+    // Биты остановки прыжков по линиям одного вида (строкам или столбцам) для обоих направлений.
+    // Прыжок останавливается на непроходимой клетке и на клетке, у которой соседняя линия проходима,
+    // а на предыдущей по ходу клетке - нет (вынужденный сосед: путь может свернуть за угол)
+    struct StopLines
+    {
+        int words = 0;                         // Слов на линию
+        int summaryWords = 0;                  // Слов сводки на линию
+        std::vector<std::uint64_t> bits[2];    // Биты остановки: [0] - прыжок к большим номерам, [1] - к меньшим (биты за концом линии - остановки)
+        std::vector<std::uint64_t> summary[2]; // Сводка: бит w - в слове w линии есть остановка
+
+        // Выделить биты lineCount линий длиной length
+        void reset(int lineCount, int length);
+        // Пересчитать слово w линии index по проходимости линии и соседних (nullptr за краем карты)
+        void refresh(int index, int w, const std::uint64_t* line, const std::uint64_t* before, const std::uint64_t* after);
+        // Прыгнуть по линии index от клетки from в направлении step (+1 или -1): позиция точки прыжка или -1.
+        // line - проходимость линии, target - позиция цели на линии или -1
+        int scan(int index, int length, int from, int step, int target, const std::uint64_t* line) const;
+    };
+
+    // Точка прыжка, достигнутая поиском
+    struct Point
+    {
+        std::uint32_t cell = 0;   // Индекс клетки (y * ширина + x)
+        std::uint32_t search = 0; // Номер поиска, в котором точка достигнута (иначе ячейка таблицы свободна)
+        float cost = 0.0f;        // Лучшая найденная длина пути до точки
+        std::uint32_t parent = 0; // Предыдущая точка пути (у начала - она сама)
+        bool closed = false;      // Точка уже раскрыта
+    };
+
+    // Элемент открытого списка
+    struct OpenEntry
+    {
+        float priority;     // Оценка длины пути через точку
+        float cost;         // Длина пути до точки
+        std::uint32_t cell; // Клетка точки
+
+        // Наверху кучи - наименьшая оценка, при равенстве - точка дальше от начала
+        bool operator<(const OpenEntry& other) const
+        {
+            return priority > other.priority || (priority == other.priority && cost < other.cost);
+        }
+    };
+
+    // Пересчитать биты остановки вокруг клетки (x, y)
+    void refreshStops(int x, int y);
+    // Прыгнуть из (x, y) в направлении (dx, dy): true и точка прыжка в (jumpX, jumpY), если она есть
+    bool jump(int x, int y, int dx, int dy, int& jumpX, int& jumpY) const;
+    // Прыгнуть по строке y начиная с клетки x в направлении dx: столбец точки прыжка или -1
+    int jumpHorizontal(int x, int y, int dx) const;
+    // Прыгнуть по столбцу x начиная с клетки y в направлении dy: строка точки прыжка или -1
+    int jumpVertical(int x, int y, int dy) const;
+    // Прыгнуть по диагонали начиная с клетки (x, y): true и точка прыжка в (x, y), если она есть
+    bool jumpDiagonal(int& x, int& y, int dx, int dy) const;
+
+    // Найти точку клетки в таблице, добавив её, если поиск ещё не достигал клетки
+    Point& visit(std::uint32_t cell);
+    // Удвоить хеш-таблицу точек
+    void growTable();
+    // Улучшить путь до точки прыжка
+    void relax(int x, int y, float cost, std::uint32_t parent);
+    // Собрать клетки пути от начала до goal по цепочке точек прыжка
+    void buildPath(std::uint32_t goal, std::vector<sf::Vector2i>& path);
+
+    PathGrid m_grid;                // Карта проходимости
+    StopLines m_rowStops;           // Остановки прыжков по строкам
+    StopLines m_columnStops;        // Остановки прыжков по столбцам
+    sf::Vector2i m_goal;            // Цель текущего поиска
+
+    // Память поиска, переиспользуемая между запросами
+    std::vector<Point> m_points;    // Хеш-таблица точек (открытая адресация, размер - степень двойки)
+    int m_tableShift;               // Сдвиг хеша до индекса таблицы
+    std::uint32_t m_pointCount;     // Точек в таблице в текущем поиске
+    std::uint32_t m_search;         // Номер текущего поиска
+    std::vector<OpenEntry> m_open;  // Открытый список (двоичная куча)
+    int m_expandedCount;            // Раскрыто точек последним поиском
+};
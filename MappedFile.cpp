@@ -0,0 +1,103 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+// Отобразить файл в память (исключение, если файл не открылся)
+MappedFile::MappedFile(const std::string& path)
+    : m_data(nullptr)
+    , m_size(0)
+    , m_file(INVALID_HANDLE_VALUE)
+    , m_mapping(nullptr)
+{
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER fileSize;
+    if (m_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_file, &fileSize))
+    {
+        if (m_file != INVALID_HANDLE_VALUE)
+            CloseHandle(m_file);
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+    m_size = static_cast<std::size_t>(fileSize.QuadPart);
+    if (m_size == 0)
+    {
+        return;
+    }
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping)
+    {
+        m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (!m_data)
+    {
+        if (m_mapping)
+            CloseHandle(m_mapping);
+        CloseHandle(m_file);
+        throw std::runtime_error("Failed to map file: " + path);
+    }
+}
+
+// Снять отображение и закрыть файл
+MappedFile::~MappedFile()
+{
+    if (m_data)
+        UnmapViewOfFile(m_data);
+    if (m_mapping)
+        CloseHandle(m_mapping);
+    CloseHandle(m_file);
+}
+
+#else
+
+// Отобразить файл в память (исключение, если файл не открылся)
+MappedFile::MappedFile(const std::string& path)
+    : m_data(nullptr)
+    , m_size(0)
+    , m_file(-1)
+{
+    m_file = open(path.c_str(), O_RDONLY);
+    struct stat fileStat;
+    if (m_file < 0 || fstat(m_file, &fileStat) != 0)
+    {
+        if (m_file >= 0)
+            close(m_file);
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+    m_size = static_cast<std::size_t>(fileStat.st_size);
+    if (m_size == 0)
+    {
+        return;
+    }
+
+    void* mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+    if (mapping == MAP_FAILED)
+    {
+        close(m_file);
+        throw std::runtime_error("Failed to map file: " + path);
+    }
+    m_data = static_cast<const char*>(mapping);
+}
+
+// Снять отображение и закрыть файл
+MappedFile::~MappedFile()
+{
+    if (m_data)
+        munmap(const_cast<char*>(m_data), m_size);
+    close(m_file);
+}
+
+#endif
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Файл, отображённый в память только для чтения (страницы подгружаются ОС при обращении)
+class MappedFile
+{
+public:
+    // Отобразить файл в память (исключение, если файл не открылся)
+    explicit MappedFile(const std::string& path);
+    // Снять отображение и закрыть файл
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Получить содержимое файла
+    const char* data() const { return m_data; }
+    // Получить размер файла в байтах
+    std::size_t size() const { return m_size; }
+
+private:
+    const char* m_data; // Начало отображения (nullptr для пустого файла)
+    std::size_t m_size; // Размер файла
+#ifdef _WIN32
+    void* m_file;       // Дескриптор файла
+    void* m_mapping;    // Дескриптор отображения
+#else
+    int m_file;         // Дескриптор файла
+#endif
+};
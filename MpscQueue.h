@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+// Неблокирующая очередь "много производителей - один потребитель" (схема Вьюкова).
+// push можно вызывать из любых потоков, tryPop - только из одного потока-потребителя.
+// Производитель делает один atomic exchange, потребитель не ждёт производителей
+template <typename T>
+class MpscQueue
+{
+public:
+    MpscQueue() : m_head(&m_stub), m_tail(&m_stub) {}
+
+    ~MpscQueue()
+    {
+        T value;
+        while (tryPop(value))
+        {
+        }
+        if (m_tail != &m_stub)
+            delete m_tail;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Добавить значение в очередь (любой поток)
+    void push(T value)
+    {
+        Node* node = new Node(std::move(value));
+        Node* previous = m_head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    // Забрать значение из очереди (только поток-потребитель); false, если очередь пуста
+    // или производитель ещё не дописал связь на свой узел
+    bool tryPop(T& value)
+    {
+        Node* tail = m_tail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next)
+            return false;
+
+        // Узел next становится новой заглушкой, его значение забирается
+        value = std::move(next->value);
+        m_tail = next;
+        if (tail != &m_stub)
+            delete tail;
+        return true;
+    }
+
+private:
+    struct Node
+    {
+        Node() : next(nullptr) {}
+        explicit Node(T&& value) : value(std::move(value)), next(nullptr) {}
+
+        T value;
+        std::atomic<Node*> next;
+    };
+
+    Node m_stub;                // Начальная заглушка
+    std::atomic<Node*> m_head;  // Последний добавленный узел (производители)
+    Node* m_tail;               // Заглушка перед первым непрочитанным узлом (потребитель)
+};
@@ -0,0 +1,267 @@
+#include "NoiseEngine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "Random.h"
+
+namespace
+{
+    // Градиенты двумерного шума: 4 оси и 4 диагонали, индекс - младшие 3 бита хеша
+    const double GradX[8] = { 1, -1, 0, 0, 1, -1, 1, -1 };
+    const double GradY[8] = { 0, 0, 1, -1, 1, 1, -1, -1 };
+
+    // Градиенты одномерного шума, индекс - младшие 4 бита хеша
+    const double Grad1D[16] =
+    {
+        -1.0, -0.875, -0.75, -0.625, -0.5, -0.375, -0.25, -0.125,
+        0.125, 0.25, 0.375, 0.5, 0.625, 0.75, 0.875, 1.0
+    };
+
+    const int RowBlockSize = 256; // Столбцов в блоке fbm2DRow с общей точкой отсчёта дробных координат
+
+    // Индекс градиента узла x строки решётки с ключом rowKey (младшие биты хеша)
+    int gradientIndex(std::uint64_t rowKey, std::int64_t x, std::uint64_t mask)
+    {
+        return static_cast<int>(mixSeed(rowKey ^ static_cast<std::uint64_t>(x)) & mask);
+    }
+
+    double fade(double t) { return t * t * t * (t * (t * 6 - 15) + 10); }
+    double lerp(double t, double a, double b) { return a + t * (b - a); }
+
+    // Варианты для float: порядок операций совпадает с векторными ядрами NoiseSimd
+    float fadeFloat(float t) { return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f); }
+    float lerpFloat(float t, float a, float b) { return a + t * (b - a); }
+
+    // Скалярный вариант NoiseSimd::addOctaveRowAvx2: добавить к total[0..count) октаву шума вдоль строки решётки
+    void addOctaveRow(const std::int32_t* lower, const std::int32_t* upper, int firstCell, float originX, float step, int first,
+        float yf, float amplitude, float* total, int count)
+    {
+        const float* gradX = NoiseSimd::GradX;
+        const float* gradY = NoiseSimd::GradY;
+        float yf1 = yf - 1.0f;
+        float v = fadeFloat(yf);
+
+        for (int i = 0; i < count; ++i)
+        {
+            float x = originX + step * static_cast<float>(first + i);
+            float floorX = std::floor(x);
+            int cell = static_cast<int>(floorX) - firstCell;
+            float xf = x - floorX;
+            float xf1 = xf - 1.0f;
+
+            int aa = lower[cell];
+            int ba = lower[cell + 1];
+            int ab = upper[cell];
+            int bb = upper[cell + 1];
+
+            float u = fadeFloat(xf);
+            float x1 = lerpFloat(u, gradX[aa] * xf + gradY[aa] * yf, gradX[ba] * xf1 + gradY[ba] * yf);
+            float x2 = lerpFloat(u, gradX[ab] * xf + gradY[ab] * yf1, gradX[bb] * xf1 + gradY[bb] * yf1);
+            total[i] = total[i] + lerpFloat(v, x1, x2) * amplitude;
+        }
+    }
+
+    // Уровень инструкций процессора определяется один раз
+    SimdLevel supportedSimdLevel()
+    {
+        static const SimdLevel level = NoiseSimd::detect();
+        return level;
+    }
+}
+
+// Подготовить хеш решётки по зерну
+NoiseEngine::NoiseEngine(std::uint32_t seed) : m_seed(seed), m_latticeKey(mixSeed(seed)), m_simdLevel(supportedSimdLevel())
+{
+}
+
+// Получить зерно генератора
+std::uint32_t NoiseEngine::getSeed() const
+{
+    return m_seed;
+}
+
+// Одномерный шум в диапазоне [-1, 1]
+double NoiseEngine::noise1D(double x) const
+{
+    double floorX = std::floor(x);
+    std::int64_t xi = static_cast<std::int64_t>(floorX);
+    double xf = x - floorX;
+
+    double g0 = Grad1D[gradientIndex(m_latticeKey, xi, 15)] * xf;
+    double g1 = Grad1D[gradientIndex(m_latticeKey, xi + 1, 15)] * (xf - 1);
+
+    // Максимум |lerp| для градиентов из [-1, 1] равен 0.5
+    return lerp(fade(xf), g0, g1) * 2;
+}
+
+// Двумерный шум в диапазоне [-1, 1]
+double NoiseEngine::noise2D(double x, double y) const
+{
+    double floorX = std::floor(x);
+    double floorY = std::floor(y);
+    std::int64_t xi = static_cast<std::int64_t>(floorX);
+    std::int64_t yi = static_cast<std::int64_t>(floorY);
+    double xf = x - floorX;
+    double yf = y - floorY;
+
+    std::uint64_t lowerKey = rowKey(yi);
+    std::uint64_t upperKey = rowKey(yi + 1);
+    int aa = gradientIndex(lowerKey, xi, 7);
+    int ab = gradientIndex(upperKey, xi, 7);
+    int ba = gradientIndex(lowerKey, xi + 1, 7);
+    int bb = gradientIndex(upperKey, xi + 1, 7);
+
+    double u = fade(xf);
+    double v = fade(yf);
+
+    double x1 = lerp(u, GradX[aa] * xf + GradY[aa] * yf, GradX[ba] * (xf - 1) + GradY[ba] * yf);
+    double x2 = lerp(u, GradX[ab] * xf + GradY[ab] * (yf - 1), GradX[bb] * (xf - 1) + GradY[bb] * (yf - 1));
+
+    // Для диагональных градиентов максимум равен 1, для осевых - меньше
+    return lerp(v, x1, x2);
+}
+
+// Сумма октав одномерного шума (fBm), нормированная в [-1, 1]
+double NoiseEngine::fbm1D(double x, int octaves, double persistence, double lacunarity) const
+{
+    double total = 0;
+    double frequency = 1;
+    double amplitude = 1;
+    double maxValue = 0;
+
+    for (int i = 0; i < octaves; i++)
+    {
+        total += noise1D(x * frequency) * amplitude;
+        maxValue += amplitude;
+
+        amplitude *= persistence;
+        frequency *= lacunarity;
+    }
+
+    return maxValue > 0 ? total / maxValue : 0;
+}
+
+// Сумма октав двумерного шума (fBm), нормированная в [-1, 1]
+double NoiseEngine::fbm2D(double x, double y, int octaves, double persistence, double lacunarity) const
+{
+    double total = 0;
+    double frequency = 1;
+    double amplitude = 1;
+    double maxValue = 0;
+
+    for (int i = 0; i < octaves; i++)
+    {
+        total += noise2D(x * frequency, y * frequency) * amplitude;
+        maxValue += amplitude;
+
+        amplitude *= persistence;
+        frequency *= lacunarity;
+    }
+
+    return maxValue > 0 ? total / maxValue : 0;
+}
+
+// Посчитать в float fbm2D(column * scale, row * scale) для столбцов column..column + count - 1 строки row
+void NoiseEngine::fbm2DRow(std::int64_t column, std::int64_t row, double scale, float* out, int count,
+    int octaves, float persistence, float lacunarity) const
+{
+    if (!(scale > 0) || !(lacunarity > 0))
+    {
+        throw std::invalid_argument("Invalid noise frequency");
+    }
+
+    std::fill(out, out + count, 0.0f);
+    std::vector<std::int32_t> lower;
+    std::vector<std::int32_t> upper;
+
+    for (int done = 0; done < count;)
+    {
+        // Дробные координаты отсчитываются от начала блока, выровненного по RowBlockSize столбцов,
+        // поэтому значение столбца зависит только от его номера
+        std::int64_t first = column + done;
+        std::int64_t anchor = first - ((first % RowBlockSize) + RowBlockSize) % RowBlockSize;
+        int offset = static_cast<int>(first - anchor);
+        int length = std::min(count - done, RowBlockSize - offset);
+        float* total = out + done;
+
+        double frequency = scale;
+        float amplitude = 1;
+        for (int octave = 0; octave < octaves; ++octave)
+        {
+            // Целая клетка решётки - в int64, в float остаются только дробные части и шаг
+            double startX = static_cast<double>(anchor) * frequency;
+            double startY = static_cast<double>(row) * frequency;
+            double floorX = std::floor(startX);
+            double floorY = std::floor(startY);
+            float originX = static_cast<float>(startX - floorX);
+            float yf = static_cast<float>(startY - floorY);
+            float step = static_cast<float>(frequency);
+
+            // Градиенты клеток, которых касаются столбцы блока (x вдоль строки не убывает)
+            int firstCell = static_cast<int>(std::floor(originX + step * static_cast<float>(offset)));
+            int lastCell = static_cast<int>(std::floor(originX + step * static_cast<float>(offset + length - 1))) + 1;
+            std::int64_t cellX = static_cast<std::int64_t>(floorX) + firstCell;
+            std::uint64_t lowerKey = rowKey(static_cast<std::int64_t>(floorY));
+            std::uint64_t upperKey = rowKey(static_cast<std::int64_t>(floorY) + 1);
+            lower.resize(lastCell - firstCell + 1);
+            upper.resize(lastCell - firstCell + 1);
+            for (std::size_t c = 0; c < lower.size(); ++c)
+            {
+                lower[c] = gradientIndex(lowerKey, cellX + static_cast<std::int64_t>(c), 7);
+                upper[c] = gradientIndex(upperKey, cellX + static_cast<std::int64_t>(c), 7);
+            }
+
+            int processed = 0;
+            switch (m_simdLevel)
+            {
+            case SimdLevel::Avx2:
+                processed = NoiseSimd::addOctaveRowAvx2(lower.data(), upper.data(), firstCell, originX, step, offset, yf, amplitude, total, length);
+                break;
+            case SimdLevel::Sse41:
+                processed = NoiseSimd::addOctaveRowSse41(lower.data(), upper.data(), firstCell, originX, step, offset, yf, amplitude, total, length);
+                break;
+            default:
+                break;
+            }
+            addOctaveRow(lower.data(), upper.data(), firstCell, originX, step, offset + processed, yf, amplitude,
+                total + processed, length - processed);
+
+            amplitude *= persistence;
+            frequency *= lacunarity;
+        }
+        done += length;
+    }
+
+    float maxValue = 0;
+    float amplitude = 1;
+    for (int octave = 0; octave < octaves; ++octave)
+    {
+        maxValue += amplitude;
+        amplitude *= persistence;
+    }
+    for (int i = 0; i < count; ++i)
+    {
+        out[i] = maxValue > 0 ? out[i] / maxValue : 0;
+    }
+}
+
+// Получить уровень векторных инструкций, используемый пакетными функциями
+SimdLevel NoiseEngine::getSimdLevel() const
+{
+    return m_simdLevel;
+}
+
+// Ограничить уровень векторных инструкций (не выше поддерживаемого процессором)
+void NoiseEngine::setSimdLevel(SimdLevel level)
+{
+    m_simdLevel = static_cast<int>(level) <= static_cast<int>(supportedSimdLevel()) ? level : supportedSimdLevel();
+}
+
+// Ключ строки y решётки (хеш узла - rowKey(y), перемешанный с x)
+std::uint64_t NoiseEngine::rowKey(std::int64_t y) const
+{
+    return mixSeed(m_latticeKey ^ static_cast<std::uint64_t>(y));
+}
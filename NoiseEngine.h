@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+#include "NoiseSimd.h"
+
+// Генератор градиентного шума (Перлин). Градиент узла решётки выбирается хешем его целых координат
+// во всю ширину int64 вместе с зерном, поэтому шум не повторяется с периодом таблицы перестановок
+class NoiseEngine
+{
+public:
+    // Подготовить хеш решётки по зерну
+    explicit NoiseEngine(std::uint32_t seed);
+
+    // Получить зерно генератора
+    std::uint32_t getSeed() const;
+
+    // Одномерный шум в диапазоне [-1, 1]
+    double noise1D(double x) const;
+    // Двумерный шум в диапазоне [-1, 1]
+    double noise2D(double x, double y) const;
+
+    // Сумма октав одномерного шума (fBm), нормированная в [-1, 1]
+    double fbm1D(double x, int octaves, double persistence, double lacunarity = 2.0) const;
+    // Сумма октав двумерного шума (fBm), нормированная в [-1, 1]
+    double fbm2D(double x, double y, int octaves, double persistence, double lacunarity = 2.0) const;
+
+    // Посчитать в float fbm2D(column * scale, row * scale) для столбцов column..column + count - 1 строки row.
+    // Для каждой октавы координата делится на целую клетку решётки (в int64) и дробную часть от начала
+    // выровненного блока столбцов, поэтому точность не падает вдали от нуля, а значение столбца
+    // не зависит ни от начала пакета, ни от уровня векторных инструкций (исключение, если scale или lacunarity не положительны)
+    void fbm2DRow(std::int64_t column, std::int64_t row, double scale, float* out, int count,
+        int octaves, float persistence, float lacunarity = 2.0f) const;
+
+    // Получить уровень векторных инструкций, используемый пакетными функциями
+    SimdLevel getSimdLevel() const;
+    // Ограничить уровень векторных инструкций (не выше поддерживаемого процессором)
+    void setSimdLevel(SimdLevel level);
+
+private:
+    // Ключ строки y решётки (хеш узла - rowKey(y), перемешанный с x)
+    std::uint64_t rowKey(std::int64_t y) const;
+
+    std::uint32_t m_seed;       // Зерно генератора
+    std::uint64_t m_latticeKey; // Ключ хеша решётки, выведенный из зерна
+    SimdLevel m_simdLevel;      // Уровень векторных инструкций
+};
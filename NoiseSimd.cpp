@@ -0,0 +1,235 @@
+#include "NoiseSimd.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define NOISE_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC разрешает интринсики без флагов компиляции, GCC/Clang нужен target для отдельных функций.
+// FMA намеренно не включается: иначе компилятор может слить умножение и сложение,
+// и результат разойдётся со скалярным вариантом.
+#if defined(NOISE_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define NOISE_TARGET_AVX2 __attribute__((target("avx2")))
+#define NOISE_TARGET_SSE41 __attribute__((target("sse4.1")))
+#else
+#define NOISE_TARGET_AVX2
+#define NOISE_TARGET_SSE41
+#endif
+
+namespace NoiseSimd
+{
+    const float GradX[8] = { 1, -1, 0, 0, 1, -1, 1, -1 };
+    const float GradY[8] = { 0, 0, 1, -1, 1, 1, -1, -1 };
+
+#if defined(NOISE_SIMD_X86)
+
+    namespace
+    {
+        // Проверить, что ОС сохраняет регистры AVX при переключении контекста
+        bool osSupportsAvx()
+        {
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 1);
+            bool osxsave = (info[2] & (1 << 27)) != 0;
+            bool avx = (info[2] & (1 << 28)) != 0;
+            return osxsave && avx && (_xgetbv(0) & 0x6) == 0x6;
+#else
+            return __builtin_cpu_supports("avx");
+#endif
+        }
+
+        // Проверить поддержку AVX2 процессором
+        bool cpuSupportsAvx2()
+        {
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7)
+                return false;
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            return __builtin_cpu_supports("avx2");
+#endif
+        }
+
+        // Проверить поддержку SSE4.1 процессором
+        bool cpuSupportsSse41()
+        {
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 1);
+            return (info[2] & (1 << 19)) != 0;
+#else
+            return __builtin_cpu_supports("sse4.1");
+#endif
+        }
+
+        // Скалярное произведение градиента (выборка перестановкой регистра) на смещение
+        NOISE_TARGET_AVX2 inline __m256 dotAvx2(__m256 gradX, __m256 gradY, __m256i hash, __m256 dx, __m256 dy)
+        {
+            __m256 gx = _mm256_permutevar8x32_ps(gradX, hash);
+            __m256 gy = _mm256_permutevar8x32_ps(gradY, hash);
+            return _mm256_add_ps(_mm256_mul_ps(gx, dx), _mm256_mul_ps(gy, dy));
+        }
+
+        // Сглаживающая функция t * t * t * (t * (t * 6 - 15) + 10)
+        NOISE_TARGET_AVX2 inline __m256 fadeAvx2(__m256 t)
+        {
+            __m256 inner = _mm256_add_ps(_mm256_mul_ps(t, _mm256_sub_ps(_mm256_mul_ps(t, _mm256_set1_ps(6.0f)), _mm256_set1_ps(15.0f))), _mm256_set1_ps(10.0f));
+            return _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(t, t), t), inner);
+        }
+
+        // Линейная интерполяция from + t * (to - from)
+        NOISE_TARGET_AVX2 inline __m256 lerpAvx2(__m256 t, __m256 from, __m256 to)
+        {
+            return _mm256_add_ps(from, _mm256_mul_ps(t, _mm256_sub_ps(to, from)));
+        }
+
+        // Скалярное произведение градиента на смещение
+        NOISE_TARGET_SSE41 inline __m128 dotSse41(const float* gx, const float* gy, __m128 dx, __m128 dy)
+        {
+            return _mm_add_ps(_mm_mul_ps(_mm_load_ps(gx), dx), _mm_mul_ps(_mm_load_ps(gy), dy));
+        }
+
+        // Сглаживающая функция t * t * t * (t * (t * 6 - 15) + 10)
+        NOISE_TARGET_SSE41 inline __m128 fadeSse41(__m128 t)
+        {
+            __m128 inner = _mm_add_ps(_mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f))), _mm_set1_ps(10.0f));
+            return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), inner);
+        }
+
+        // Линейная интерполяция from + t * (to - from)
+        NOISE_TARGET_SSE41 inline __m128 lerpSse41(__m128 t, __m128 from, __m128 to)
+        {
+            return _mm_add_ps(from, _mm_mul_ps(t, _mm_sub_ps(to, from)));
+        }
+    }
+
+    // Определить лучший уровень инструкций, поддерживаемый процессором и ОС
+    SimdLevel detect()
+    {
+        if (osSupportsAvx() && cpuSupportsAvx2())
+            return SimdLevel::Avx2;
+        if (cpuSupportsSse41())
+            return SimdLevel::Sse41;
+        return SimdLevel::Scalar;
+    }
+
+    // Добавить октаву шума к 8 значениям за раз (AVX2; тот же порядок операций, что и в скалярном NoiseEngine)
+    NOISE_TARGET_AVX2 int addOctaveRowAvx2(const std::int32_t* lower, const std::int32_t* upper, int firstCell, float originX, float step, int first,
+        float yf, float amplitude, float* total, int count)
+    {
+        const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i base = _mm256_set1_epi32(firstCell);
+        const __m256 oneF = _mm256_set1_ps(1.0f);
+        const __m256 gradX = _mm256_loadu_ps(GradX);
+        const __m256 gradY = _mm256_loadu_ps(GradY);
+        const __m256 origin = _mm256_set1_ps(originX);
+        const __m256 stepX = _mm256_set1_ps(step);
+        const __m256 scale = _mm256_set1_ps(amplitude);
+        const __m256 y = _mm256_set1_ps(yf);
+        const __m256 y1 = _mm256_sub_ps(y, oneF);
+        const __m256 v = fadeAvx2(y);
+
+        int processed = count - count % 8;
+        for (int i = 0; i < processed; i += 8)
+        {
+            __m256 index = _mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_set1_epi32(first + i), lanes));
+            __m256 x = _mm256_add_ps(origin, _mm256_mul_ps(stepX, index));
+            __m256 floorX = _mm256_floor_ps(x);
+            __m256i cell = _mm256_sub_epi32(_mm256_cvttps_epi32(floorX), base);
+            __m256i next = _mm256_add_epi32(cell, one);
+            __m256 xf = _mm256_sub_ps(x, floorX);
+            __m256 xf1 = _mm256_sub_ps(xf, oneF);
+
+            __m256i aa = _mm256_i32gather_epi32(lower, cell, 4);
+            __m256i ba = _mm256_i32gather_epi32(lower, next, 4);
+            __m256i ab = _mm256_i32gather_epi32(upper, cell, 4);
+            __m256i bb = _mm256_i32gather_epi32(upper, next, 4);
+
+            __m256 u = fadeAvx2(xf);
+            __m256 x1 = lerpAvx2(u, dotAvx2(gradX, gradY, aa, xf, y), dotAvx2(gradX, gradY, ba, xf1, y));
+            __m256 x2 = lerpAvx2(u, dotAvx2(gradX, gradY, ab, xf, y1), dotAvx2(gradX, gradY, bb, xf1, y1));
+            __m256 value = lerpAvx2(v, x1, x2);
+            _mm256_storeu_ps(total + i, _mm256_add_ps(_mm256_loadu_ps(total + i), _mm256_mul_ps(value, scale)));
+        }
+        return processed;
+    }
+
+    // Добавить октаву шума к 4 значениям за раз (SSE4.1; тот же порядок операций, что и в скалярном NoiseEngine)
+    NOISE_TARGET_SSE41 int addOctaveRowSse41(const std::int32_t* lower, const std::int32_t* upper, int firstCell, float originX, float step, int first,
+        float yf, float amplitude, float* total, int count)
+    {
+        const __m128i lanes = _mm_setr_epi32(0, 1, 2, 3);
+        const __m128 oneF = _mm_set1_ps(1.0f);
+        const __m128 origin = _mm_set1_ps(originX);
+        const __m128 stepX = _mm_set1_ps(step);
+        const __m128 scale = _mm_set1_ps(amplitude);
+        const __m128 y = _mm_set1_ps(yf);
+        const __m128 y1 = _mm_sub_ps(y, oneF);
+        const __m128 v = fadeSse41(y);
+
+        int processed = count - count % 4;
+        for (int i = 0; i < processed; i += 4)
+        {
+            __m128 index = _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(first + i), lanes));
+            __m128 x = _mm_add_ps(origin, _mm_mul_ps(stepX, index));
+            __m128 floorX = _mm_floor_ps(x);
+            alignas(16) std::int32_t cell[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(cell), _mm_sub_epi32(_mm_cvttps_epi32(floorX), _mm_set1_epi32(firstCell)));
+            __m128 xf = _mm_sub_ps(x, floorX);
+            __m128 xf1 = _mm_sub_ps(xf, oneF);
+
+            // В SSE нет выборки по индексам, градиенты выбираются по линиям
+            alignas(16) float gaaX[4], gaaY[4], gabX[4], gabY[4], gbaX[4], gbaY[4], gbbX[4], gbbY[4];
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                int aa = lower[cell[lane]];
+                int ba = lower[cell[lane] + 1];
+                int ab = upper[cell[lane]];
+                int bb = upper[cell[lane] + 1];
+                gaaX[lane] = GradX[aa];
+                gaaY[lane] = GradY[aa];
+                gabX[lane] = GradX[ab];
+                gabY[lane] = GradY[ab];
+                gbaX[lane] = GradX[ba];
+                gbaY[lane] = GradY[ba];
+                gbbX[lane] = GradX[bb];
+                gbbY[lane] = GradY[bb];
+            }
+
+            __m128 u = fadeSse41(xf);
+            __m128 x1 = lerpSse41(u, dotSse41(gaaX, gaaY, xf, y), dotSse41(gbaX, gbaY, xf1, y));
+            __m128 x2 = lerpSse41(u, dotSse41(gabX, gabY, xf, y1), dotSse41(gbbX, gbbY, xf1, y1));
+            __m128 value = lerpSse41(v, x1, x2);
+            _mm_storeu_ps(total + i, _mm_add_ps(_mm_loadu_ps(total + i), _mm_mul_ps(value, scale)));
+        }
+        return processed;
+    }
+
+#else
+
+    // Векторные инструкции x86 недоступны: всё считается скалярным кодом
+    SimdLevel detect()
+    {
+        return SimdLevel::Scalar;
+    }
+
+    int addOctaveRowAvx2(const std::int32_t*, const std::int32_t*, int, float, float, int, float, float, float*, int)
+    {
+        return 0;
+    }
+
+    int addOctaveRowSse41(const std::int32_t*, const std::int32_t*, int, float, float, int, float, float, float*, int)
+    {
+        return 0;
+    }
+
+#endif
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+// Уровень векторных инструкций, доступный процессору
+enum class SimdLevel
+{
+    Scalar, // Без векторизации
+    Sse41,  // SSE4.1, 4 значения за раз
+    Avx2    // AVX2, 8 значений за раз
+};
+
+// Векторные ядра шума (используются NoiseEngine, результаты побитово совпадают со скалярным float-вариантом)
+namespace NoiseSimd
+{
+    // Градиенты двумерного шума в float (те же, что и в double-варианте)
+    extern const float GradX[8];
+    extern const float GradY[8];
+
+    // Определить лучший уровень инструкций, поддерживаемый процессором и ОС
+    SimdLevel detect();
+
+    // Добавить к total[0..count) октаву двумерного шума вдоль строки решётки: значение i берётся в точке
+    // x = originX + step * (first + i) с дробной частью y = yf, отсчитанной от клетки решётки 0 этой октавы.
+    // lower[c - firstCell] и upper[c - firstCell] - индексы градиентов углов клетки c в нижней и верхней строке решётки.
+    // Вернуть количество обработанных значений (кратно ширине вектора, остаток досчитывает вызывающий скалярным кодом)
+    int addOctaveRowAvx2(const std::int32_t* lower, const std::int32_t* upper, int firstCell, float originX, float step, int first,
+        float yf, float amplitude, float* total, int count);
+    int addOctaveRowSse41(const std::int32_t* lower, const std::int32_t* upper, int firstCell, float originX, float step, int first,
+        float yf, float amplitude, float* total, int count);
+}
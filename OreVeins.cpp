@@ -0,0 +1,160 @@
+#include "OreVeins.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "Random.h"
+#include "TerrainGenerator.h"
+#include "World.h"
+
+namespace
+{
+    // Ключи независимых случайных значений затравки, выводимых из хеша её клетки решётки
+    const std::uint64_t PriorityKey = 1; // Приоритет при конфликте с соседями
+    const std::uint64_t WalkKey = 2;     // Длина и блуждание жилы
+
+    // Сдвиг шага жилы по осям для каждого из четырёх направлений
+    const int StepX[4] = { 1, -1, 0, 0 };
+    const int StepY[4] = { 0, 0, 1, -1 };
+
+    // Кандидат в затравки: одна случайная точка на клетку решётки с шагом spacing
+    struct Candidate
+    {
+        int x;              // Столбец мира
+        int y;              // Строка мира
+        std::uint64_t hash; // Хеш клетки решётки (из него выводятся остальные значения кандидата)
+        bool valid;         // Точка попала в диапазон глубин руды и прошла отбор по шансу
+    };
+
+    // Получить целое в [0, bound) по 16 младшим битам value (умножением, без деления)
+    int scaleBelow(std::uint64_t value, int bound)
+    {
+        return static_cast<int>(((value & 0xFFFF) * static_cast<std::uint64_t>(bound)) >> 16);
+    }
+
+    // Получить кандидата клетки решётки (gridX, gridY) для руды type. Кандидат целиком выводится из одного
+    // хеша клетки: младшие биты задают точку в клетке, старшие 32 - отбор по шансу руды на её глубине
+    Candidate makeCandidate(std::uint64_t oreSeed, const VeinType& type, int gridX, int gridY)
+    {
+        Candidate candidate;
+        candidate.hash = mixSeed(oreSeed ^ World::chunkKey(gridX, gridY));
+        candidate.x = gridX * type.spacing + scaleBelow(candidate.hash, type.spacing);
+        candidate.y = gridY * type.spacing + scaleBelow(candidate.hash >> 16, type.spacing);
+        candidate.valid = candidate.y >= type.top && candidate.y < type.bottom
+            && static_cast<double>(candidate.hash >> 32) * (1.0 / 4294967296.0) < type.seedChance[candidate.y - type.top];
+        return candidate;
+    }
+
+    // Получить приоритет кандидата при конфликте с соседями (больше - сильнее); считается только при конфликте
+    std::uint64_t getPriority(const Candidate& candidate)
+    {
+        return mixSeed(candidate.hash ^ PriorityKey);
+    }
+
+    // Пройти жилу длиной size от затравки (x, y) и заменить камень участка на руду tile.
+    // Направления шагов берутся по два бита из хешей walkSeed, поэтому путь не зависит от участка и чанки стыкуются
+    void growVein(TileGrid& region, int originX, int originY, TileId tile, int x, int y, int size, std::uint64_t walkSeed)
+    {
+        std::uint64_t directions = 0;
+        for (int step = 0; step < size; ++step)
+        {
+            int localX = x - originX;
+            int localY = y - originY;
+            if (region.contains(localX, localY) && region(localX, localY) == RockTile)
+                region(localX, localY) = tile;
+
+            if (step % 32 == 0)
+                directions = mixSeed(walkSeed + static_cast<std::uint64_t>(step));
+            x += StepX[directions & 3];
+            y += StepY[directions & 3];
+            directions >>= 2;
+        }
+    }
+}
+
+// Разместить руды жилами (параметры - в таблицах resources) в камне участка region, лежащего в мире начиная с тайла (originX, originY)
+void generateOreVeins(TileGrid& region, int originX, int originY, const ResourceTables& resources, std::uint64_t worldSeed)
+{
+    if (region.getWidth() == 0 || region.getHeight() == 0)
+    {
+        return;
+    }
+
+    const std::uint64_t veinSeed = deriveSeed(worldSeed, OreVeinStream);
+    std::vector<Candidate> grid; // Решётка кандидатов: соседи по расстоянию ищутся только в соседних клетках
+    for (const VeinType& type : resources.getVeins())
+    {
+        // Зерно руды выводится из её тайла, а не из места в файле определений
+        const std::uint64_t oreSeed = deriveSeed(veinSeed, type.tile);
+
+        // Жилы, которые могут задеть участок: затравки внутри диапазона глубин и не дальше,
+        // чем жила этой руды уходит от затравки (maxSize - 1 шагов)
+        const int margin = type.maxSize - 1;
+        int firstX = floorDiv(originX - margin, type.spacing);
+        int lastX = floorDiv(originX + region.getWidth() - 1 + margin, type.spacing);
+        int firstY = floorDiv(std::max(type.top, originY - margin), type.spacing);
+        int lastY = floorDiv(std::min(type.bottom - 1, originY + region.getHeight() - 1 + margin), type.spacing);
+        if (firstY > lastY)
+            continue;
+
+        // Кандидаты этих клеток и их соседей (для проверки расстояний), клетка (firstX - 1, firstY - 1) - первая
+        const int gridWidth = lastX - firstX + 3;
+        grid.clear();
+        for (int gridY = firstY - 1; gridY <= lastY + 1; ++gridY)
+        {
+            for (int gridX = firstX - 1; gridX <= lastX + 1; ++gridX)
+            {
+                grid.push_back(makeCandidate(oreSeed, type, gridX, gridY));
+            }
+        }
+        auto cell = [&](int gridX, int gridY) -> const Candidate&
+        {
+            return grid[static_cast<std::size_t>(gridY - firstY + 1) * gridWidth + (gridX - firstX + 1)];
+        };
+
+        // Затравка остаётся, если в радиусе spacing нет кандидата сильнее: такие затравки
+        // не ближе spacing друг к другу, а решение принимается по соседним клеткам решётки
+        // (шаг решётки равен spacing) и поэтому одинаково для любого участка
+        const int minDistance2 = type.spacing * type.spacing;
+        const int lastColumn = originX + region.getWidth() - 1;
+        const int lastRow = originY + region.getHeight() - 1;
+        for (int gridY = firstY; gridY <= lastY; ++gridY)
+        {
+            for (int gridX = firstX; gridX <= lastX; ++gridX)
+            {
+                const Candidate& candidate = cell(gridX, gridY);
+                if (!candidate.valid)
+                    continue;
+
+                // За size - 1 шагов жила уходит от затравки не дальше size - 1 по манхэттенскому расстоянию:
+                // если участок дальше, ни соседи, ни блуждание не нужны
+                const std::uint64_t walkSeed = mixSeed(candidate.hash ^ WalkKey);
+                int size = type.minSize + scaleBelow(walkSeed, type.maxSize - type.minSize + 1);
+                int distanceX = std::max(std::max(originX - candidate.x, candidate.x - lastColumn), 0);
+                int distanceY = std::max(std::max(originY - candidate.y, candidate.y - lastRow), 0);
+                if (distanceX + distanceY >= size)
+                    continue;
+
+                bool accepted = true;
+                for (int dy = -1; dy <= 1 && accepted; ++dy)
+                {
+                    for (int dx = -1; dx <= 1; ++dx)
+                    {
+                        if (dx == 0 && dy == 0)
+                            continue;
+                        const Candidate& other = cell(gridX + dx, gridY + dy);
+                        int otherX = other.x - candidate.x;
+                        int otherY = other.y - candidate.y;
+                        if (other.valid && otherX * otherX + otherY * otherY < minDistance2 && getPriority(other) > getPriority(candidate))
+                        {
+                            accepted = false;
+                            break;
+                        }
+                    }
+                }
+                if (accepted)
+                    growVein(region, originX, originY, type.tile, candidate.x, candidate.y, size, walkSeed);
+            }
+        }
+    }
+}
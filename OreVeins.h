@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+
+#include "ResourceTables.h"
+#include "TileGrid.h"
+
+// Разместить руды жилами (параметры - в таблицах resources) в камне участка region, лежащего
+// в мире начиная с тайла (originX, originY). Затравки жил каждой руды выбираются в её диапазоне глубин с разносом
+// по Пуассону (не ближе заданного расстояния друг к другу) и с плотностью по шансу руды на их глубине
+// (жилы занимают примерно ту же долю камня, что и руда при размещении по клеткам), а жила растёт от затравки
+// случайным блужданием. Блуждания пропорциональны объёму руды; кандидатов в затравки - по одному на клетку
+// решётки spacing x spacing участка и запаса вокруг него на длину жилы, поэтому маленькие участки (чанки) платят за запас.
+// Затравки и блуждание зависят только от зерна мира и координат, поэтому жила, пересекающая
+// границу чанков, продолжается в соседнем чанке
+void generateOreVeins(TileGrid& region, int originX, int originY, const ResourceTables& resources, std::uint64_t worldSeed);
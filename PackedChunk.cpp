@@ -0,0 +1,194 @@
+#include "PackedChunk.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    const int MaxBitsPerTile = 8; // Ширина индекса, которой хватает на любой TileId
+
+    // Получить наименьшую допустимую ширину индекса для палитры из count типов
+    int bitsForPalette(std::size_t count)
+    {
+        int bits = 0;
+        while ((static_cast<std::size_t>(1) << bits) < count)
+            bits = bits == 0 ? 1 : bits * 2;
+        return bits;
+    }
+
+    // Получить log2 ширины индекса
+    int bitsShift(int bits)
+    {
+        int shift = 0;
+        while ((1 << shift) < bits)
+            ++shift;
+        return shift;
+    }
+}
+
+// Создать пустой чанк
+PackedChunk::PackedChunk() : PackedChunk(0, 0)
+{
+}
+
+// Создать чанк указанного размера, заполненный тайлом fill
+PackedChunk::PackedChunk(int width, int height, TileId fill)
+    : m_width(width)
+    , m_height(height)
+    , m_bits(0)
+    , m_bitsShift(0)
+    , m_mask(0)
+    , m_palette(1, fill)
+{
+    if (width < 0 || height < 0)
+    {
+        throw std::invalid_argument("Invalid chunk size");
+    }
+}
+
+// Упаковать карту тайлов (палитра - только встречающиеся типы)
+PackedChunk::PackedChunk(const TileGrid& tiles) : PackedChunk(tiles.getWidth(), tiles.getHeight())
+{
+    if (tiles.size() == 0)
+    {
+        return;
+    }
+
+    // Палитра в порядке первого появления, индексы через таблицу на все значения TileId
+    int paletteIndex[256];
+    std::fill(std::begin(paletteIndex), std::end(paletteIndex), -1);
+    m_palette.clear();
+    const TileId* data = tiles.data();
+    for (std::size_t i = 0; i < tiles.size(); ++i)
+    {
+        if (paletteIndex[data[i]] < 0)
+        {
+            paletteIndex[data[i]] = static_cast<int>(m_palette.size());
+            m_palette.push_back(data[i]);
+        }
+    }
+
+    setBitsPerTile(bitsForPalette(m_palette.size()));
+    if (m_bits == 0)
+    {
+        return;
+    }
+    for (std::size_t i = 0; i < tiles.size(); ++i)
+    {
+        writeIndex(i, static_cast<std::uint64_t>(paletteIndex[data[i]]));
+    }
+}
+
+// Изменить тайл без проверки границ (при новом типе палитра растёт, индексы могут расшириться)
+void PackedChunk::set(int x, int y, TileId tile)
+{
+    int paletteIndex = findPaletteIndex(tile);
+    if (paletteIndex < 0)
+    {
+        paletteIndex = static_cast<int>(m_palette.size());
+        m_palette.push_back(tile);
+        int bits = bitsForPalette(m_palette.size());
+        if (bits > m_bits)
+            setBitsPerTile(bits);
+    }
+    if (m_bits != 0)
+    {
+        writeIndex(static_cast<std::size_t>(y) * m_width + x, static_cast<std::uint64_t>(paletteIndex));
+    }
+}
+
+// Распаковать строку чанка в out[0..getWidth())
+void PackedChunk::decodeRow(int y, TileId* out) const
+{
+    if (m_bits == 0)
+    {
+        std::fill(out, out + m_width, m_palette[0]);
+        return;
+    }
+
+    // Слово читается один раз, из него подряд снимаются все индексы строки, что в нём лежат
+    const std::size_t perWord = static_cast<std::size_t>(64 >> m_bitsShift);
+    std::size_t index = static_cast<std::size_t>(y) * m_width;
+    const TileId* palette = m_palette.data();
+    for (int x = 0; x < m_width;)
+    {
+        std::size_t inWord = index & (perWord - 1);
+        std::uint64_t word = m_words[index >> (6 - m_bitsShift)] >> (inWord << m_bitsShift);
+        int count = static_cast<int>(std::min<std::size_t>(perWord - inWord, static_cast<std::size_t>(m_width - x)));
+        for (int i = 0; i < count; ++i)
+        {
+            out[x + i] = palette[word & m_mask];
+            word >>= m_bits;
+        }
+        x += count;
+        index += count;
+    }
+}
+
+// Распаковать чанк в карту тайлов
+TileGrid PackedChunk::unpack() const
+{
+    TileGrid tiles(m_width, m_height);
+    for (int y = 0; y < m_height; ++y)
+    {
+        decodeRow(y, tiles.row(y).data());
+    }
+    return tiles;
+}
+
+// Получить память, занятую палитрой и индексами (без самого объекта)
+std::size_t PackedChunk::getDataBytes() const
+{
+    return m_palette.capacity() * sizeof(TileId) + m_words.capacity() * sizeof(std::uint64_t);
+}
+
+// Найти тип в палитре; -1, если его там нет
+int PackedChunk::findPaletteIndex(TileId tile) const
+{
+    auto it = std::find(m_palette.begin(), m_palette.end(), tile);
+    return it != m_palette.end() ? static_cast<int>(it - m_palette.begin()) : -1;
+}
+
+// Переупаковать индексы с шириной bits
+void PackedChunk::setBitsPerTile(int bits)
+{
+    if (bits > MaxBitsPerTile)
+    {
+        throw std::logic_error("Chunk palette is larger than the tile id range");
+    }
+
+    std::size_t count = static_cast<std::size_t>(m_width) * m_height;
+    std::vector<std::uint64_t> oldWords;
+    oldWords.swap(m_words);
+    int oldBits = m_bits;
+    int oldShift = m_bitsShift;
+    std::uint64_t oldMask = m_mask;
+
+    m_bits = bits;
+    m_bitsShift = bitsShift(bits);
+    m_mask = bits == 0 ? 0 : (static_cast<std::uint64_t>(1) << bits) - 1;
+    if (bits == 0)
+    {
+        return;
+    }
+
+    std::size_t perWord = static_cast<std::size_t>(64 >> m_bitsShift);
+    m_words.assign((count + perWord - 1) / perWord, 0);
+    if (oldBits == 0)
+    {
+        return; // Все тайлы - нулевой элемент палитры, нулевые слова это и означают
+    }
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        std::uint64_t word = oldWords[i >> (6 - oldShift)];
+        writeIndex(i, (word >> ((i << oldShift) & 63)) & oldMask);
+    }
+}
+
+// Записать индекс палитры тайла index (ширина индекса не меньше 1 бита)
+void PackedChunk::writeIndex(std::size_t index, std::uint64_t paletteIndex)
+{
+    std::uint64_t& word = m_words[index >> (6 - m_bitsShift)];
+    int shift = static_cast<int>((index << m_bitsShift) & 63);
+    word = (word & ~(m_mask << shift)) | (paletteIndex << shift);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "TileGrid.h"
+
+// Чанк, сжатый палитрой: хранит список встречающихся в нём типов тайлов и для каждого тайла
+// индекс в этом списке, упакованный в 0, 1, 2, 4 или 8 бит. Однородный чанк (всё небо,
+// весь камень) не занимает под тайлы ничего, камень с рудами - 1-2 бита на тайл.
+// Когда в чанке появляется новый тип, а индексы уже не помещаются, ширина индекса удваивается
+class PackedChunk
+{
+public:
+    // Создать пустой чанк
+    PackedChunk();
+    // Создать чанк указанного размера, заполненный тайлом fill
+    PackedChunk(int width, int height, TileId fill = 0);
+    // Упаковать карту тайлов (палитра - только встречающиеся типы)
+    explicit PackedChunk(const TileGrid& tiles);
+
+    // Получить ширину чанка в тайлах
+    int getWidth() const { return m_width; }
+    // Получить высоту чанка в тайлах
+    int getHeight() const { return m_height; }
+    // Проверить, что координаты лежат внутри чанка
+    bool contains(int x, int y) const { return x >= 0 && y >= 0 && x < m_width && y < m_height; }
+
+    // Получить тайл без проверки границ
+    TileId get(int x, int y) const
+    {
+        if (m_bits == 0)
+            return m_palette[0];
+        std::size_t index = static_cast<std::size_t>(y) * m_width + x;
+        std::uint64_t word = m_words[index >> (6 - m_bitsShift)];
+        return m_palette[static_cast<std::size_t>((word >> ((index << m_bitsShift) & 63)) & m_mask)];
+    }
+    // Изменить тайл без проверки границ (при новом типе палитра растёт, индексы могут расшириться)
+    void set(int x, int y, TileId tile);
+    // Распаковать строку чанка в out[0..getWidth())
+    void decodeRow(int y, TileId* out) const;
+    // Распаковать чанк в карту тайлов
+    TileGrid unpack() const;
+
+    // Получить ширину индекса палитры в битах (0, 1, 2, 4 или 8)
+    int getBitsPerTile() const { return m_bits; }
+    // Получить палитру чанка
+    const std::vector<TileId>& getPalette() const { return m_palette; }
+    // Получить память, занятую палитрой и индексами (без самого объекта)
+    std::size_t getDataBytes() const;
+
+private:
+    // Найти тип в палитре; -1, если его там нет
+    int findPaletteIndex(TileId tile) const;
+    // Переупаковать индексы с шириной bits
+    void setBitsPerTile(int bits);
+    // Записать индекс палитры тайла index (ширина индекса не меньше 1 бита)
+    void writeIndex(std::size_t index, std::uint64_t paletteIndex);
+
+    int m_width;                        // Ширина чанка в тайлах
+    int m_height;                       // Высота чанка в тайлах
+    int m_bits;                         // Ширина индекса в битах
+    int m_bitsShift;                    // log2(m_bits) для ненулевой ширины
+    std::uint64_t m_mask;               // Маска индекса
+    std::vector<TileId> m_palette;      // Типы тайлов, встречающиеся в чанке
+    std::vector<std::uint64_t> m_words; // Индексы палитры, упакованные в 64-битные слова (индекс не пересекает слово)
+};
@@ -0,0 +1,141 @@
+#include "PathGrid.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+#include "TileRegistry.h"
+
+namespace
+{
+    // Проверить размер карты по одной оси (исключение, если он отрицательный)
+    int checkedSize(int size)
+    {
+        if (size < 0)
+        {
+            throw std::invalid_argument("Invalid path grid size");
+        }
+        return size;
+    }
+}
+
+// Создать пустую карту
+PathGrid::PathGrid() : m_width(0), m_height(0), m_wordsPerRow(0), m_wordsPerColumn(0)
+{
+}
+
+// Создать карту width x height, все клетки которой непроходимы
+PathGrid::PathGrid(int width, int height)
+    : m_width(checkedSize(width))
+    , m_height(checkedSize(height))
+    , m_wordsPerRow((m_width + 63) / 64)
+    , m_wordsPerColumn((m_height + 63) / 64)
+{
+    m_rows.assign(static_cast<std::size_t>(m_wordsPerRow) * height, 0);
+    m_columns.assign(static_cast<std::size_t>(m_wordsPerColumn) * width, 0);
+}
+
+// Построить карту по карте тайлов: проходимы тайлы без флага TileSolid
+PathGrid::PathGrid(const TileGrid& tiles, const TileRegistry& tileRegistry)
+    : PathGrid(tiles.getWidth(), tiles.getHeight())
+{
+    // Проходимость типа считается один раз, а не для каждого тайла
+    bool passable[TileRegistry::MaxTileTypes];
+    for (int id = 0; id < TileRegistry::MaxTileTypes; ++id)
+    {
+        passable[id] = !(tileRegistry[static_cast<TileId>(id)].flags & TileSolid);
+    }
+
+    for (int y = 0; y < m_height; ++y)
+    {
+        TileSpan<const TileId> source = tiles.row(y);
+        std::uint64_t* words = m_rows.data() + static_cast<std::size_t>(y) * m_wordsPerRow;
+        for (int x = 0; x < m_width; x += 64)
+        {
+            int count = std::min(64, m_width - x);
+            std::uint64_t word = 0;
+            for (int i = 0; i < count; ++i)
+            {
+                word |= static_cast<std::uint64_t>(passable[source[x + i]]) << i;
+            }
+            words[x >> 6] = word;
+        }
+    }
+
+    // Столбцы заполняются по проходимым клеткам строк: обычно их меньше, чем всех клеток
+    for (int y = 0; y < m_height; ++y)
+    {
+        const std::uint64_t* words = row(y);
+        std::uint64_t bit = 1ull << (y & 63);
+        for (int w = 0; w < m_wordsPerRow; ++w)
+        {
+            for (std::uint64_t word = words[w]; word != 0; word &= word - 1)
+            {
+                int x = w * 64 + countTrailingZeros(word);
+                m_columns[static_cast<std::size_t>(x) * m_wordsPerColumn + (y >> 6)] |= bit;
+            }
+        }
+    }
+}
+
+// Изменить проходимость клетки (исключение, если координаты вне карты)
+void PathGrid::setPassable(int x, int y, bool passable)
+{
+    if (!contains(x, y))
+    {
+        throw std::out_of_range("Cell out of range: " + std::to_string(x) + ", " + std::to_string(y));
+    }
+    std::uint64_t bit = 1ull << (x & 63);
+    std::uint64_t columnBit = 1ull << (y & 63);
+    std::uint64_t& columnWord = m_columns[static_cast<std::size_t>(x) * m_wordsPerColumn + (y >> 6)];
+    if (passable)
+    {
+        m_rows[index(x, y)] |= bit;
+        columnWord |= columnBit;
+    }
+    else
+    {
+        m_rows[index(x, y)] &= ~bit;
+        columnWord &= ~columnBit;
+    }
+}
+
+// Проверить, что из (fromX, fromY) в (toX, toY) ведёт прямой путь ходами в 8 сторон
+bool PathGrid::hasStraightPath(int fromX, int fromY, int toX, int toY, bool& diagonalFirst) const
+{
+    const int dx = (toX > fromX) - (toX < fromX);
+    const int dy = (toY > fromY) - (toY < fromY);
+    const int diagonal = std::min(std::abs(toX - fromX), std::abs(toY - fromY));
+    const int straight = std::max(std::abs(toX - fromX), std::abs(toY - fromY)) - diagonal;
+    const bool horizontal = std::abs(toX - fromX) > std::abs(toY - fromY);
+
+    for (int order = 0; order < 2; ++order)
+    {
+        diagonalFirst = order == 0;
+        int x = fromX;
+        int y = fromY;
+        bool open = isPassable(x, y);
+        for (int i = 0; i < diagonal + straight && open; ++i)
+        {
+            // Ход по диагонали разрешён, только если проходимы обе клетки по сторонам от него
+            if (diagonalFirst ? i < diagonal : i >= straight)
+            {
+                open = isPassable(x + dx, y) && isPassable(x, y + dy) && isPassable(x + dx, y + dy);
+                x += dx;
+                y += dy;
+            }
+            else
+            {
+                x += horizontal ? dx : 0;
+                y += horizontal ? 0 : dy;
+                open = isPassable(x, y);
+            }
+        }
+        if (open)
+            return true;
+        if (diagonal == 0 || straight == 0)
+            break;
+    }
+    return false;
+}
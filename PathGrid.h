@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "TileGrid.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+class TileRegistry;
+
+// Получить номер младшего единичного бита (word не ноль)
+inline int countTrailingZeros(std::uint64_t word)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#elif defined(_MSC_VER)
+    // 64-битных команд поиска бита в 32-битной сборке нет: слово проверяется половинами
+    unsigned long index;
+    if (_BitScanForward(&index, static_cast<unsigned long>(word)))
+        return static_cast<int>(index);
+    _BitScanForward(&index, static_cast<unsigned long>(word >> 32));
+    return static_cast<int>(index) + 32;
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+// Получить количество нулевых бит выше старшего единичного (word не ноль)
+inline int countLeadingZeros(std::uint64_t word)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long index;
+    _BitScanReverse64(&index, word);
+    return 63 - static_cast<int>(index);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    if (_BitScanReverse(&index, static_cast<unsigned long>(word >> 32)))
+        return 31 - static_cast<int>(index);
+    _BitScanReverse(&index, static_cast<unsigned long>(word));
+    return 63 - static_cast<int>(index);
+#else
+    return __builtin_clzll(word);
+#endif
+}
+
+// Карта проходимости для поиска пути: бит на клетку (1 - проходима), строки хранятся 64-битными словами.
+// Те же биты хранятся и по столбцам, чтобы просмотр вдоль вертикали тоже шёл словами.
+// Клетки вне карты считаются непроходимыми
+class PathGrid
+{
+public:
+    // Создать пустую карту
+    PathGrid();
+    // Создать карту width x height, все клетки которой непроходимы
+    PathGrid(int width, int height);
+    // Построить карту по карте тайлов: проходимы тайлы без флага TileSolid
+    PathGrid(const TileGrid& tiles, const TileRegistry& tileRegistry);
+
+    // Получить ширину карты в клетках
+    int getWidth() const { return m_width; }
+    // Получить высоту карты в клетках
+    int getHeight() const { return m_height; }
+    // Проверить, что координаты лежат внутри карты
+    bool contains(int x, int y) const { return x >= 0 && y >= 0 && x < m_width && y < m_height; }
+
+    // Проверить, что клетка проходима (false вне карты)
+    bool isPassable(int x, int y) const
+    {
+        return contains(x, y) && (m_rows[index(x, y)] >> (x & 63) & 1) != 0;
+    }
+    // Изменить проходимость клетки (исключение, если координаты вне карты)
+    void setPassable(int x, int y, bool passable);
+
+    // Проверить, что из (fromX, fromY) в (toX, toY) ведёт прямой путь ходами в 8 сторон: сначала по диагонали,
+    // затем по прямой, или наоборот (diagonalFirst получает порядок). Длина такого пути равна октильному расстоянию,
+    // короче пути нет
+    bool hasStraightPath(int fromX, int fromY, int toX, int toY, bool& diagonalFirst) const;
+
+    // Получить слова строки y (бит i слова w - клетка w * 64 + i, биты за шириной карты нулевые)
+    const std::uint64_t* row(int y) const { return m_rows.data() + static_cast<std::size_t>(y) * m_wordsPerRow; }
+    // Получить количество слов в строке
+    int getWordsPerRow() const { return m_wordsPerRow; }
+    // Получить слова столбца x (бит i слова w - клетка в строке w * 64 + i, биты за высотой карты нулевые)
+    const std::uint64_t* column(int x) const { return m_columns.data() + static_cast<std::size_t>(x) * m_wordsPerColumn; }
+    // Получить количество слов в столбце
+    int getWordsPerColumn() const { return m_wordsPerColumn; }
+
+private:
+    std::size_t index(int x, int y) const { return static_cast<std::size_t>(y) * m_wordsPerRow + (x >> 6); }
+
+    int m_width;                          // Ширина карты в клетках
+    int m_height;                         // Высота карты в клетках
+    int m_wordsPerRow;                    // Слов на строку
+    int m_wordsPerColumn;                 // Слов на столбец
+    std::vector<std::uint64_t> m_rows;    // Биты проходимости (построчно)
+    std::vector<std::uint64_t> m_columns; // Те же биты по столбцам
+};
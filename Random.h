@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+
+// Перемешать 64-битное значение (финализатор SplitMix64)
+inline std::uint64_t mixSeed(std::uint64_t value)
+{
+    value += 0x9E3779B97F4A7C15ull;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+// Получить зерно независимого потока по зерну родителя и ключу потока
+inline std::uint64_t deriveSeed(std::uint64_t seed, std::uint64_t key)
+{
+    return mixSeed(seed ^ mixSeed(key));
+}
+
+// Быстрый генератор псевдослучайных чисел xoshiro256** со своим состоянием.
+// В отличие от rand() не имеет общего состояния: каждый поток генерации
+// (тип ресурса, чанк) заводит свой экземпляр с зерном из deriveSeed
+class RandomStream
+{
+public:
+    // Инициализировать состояние по зерну (через SplitMix64, как рекомендуют авторы xoshiro)
+    explicit RandomStream(std::uint64_t seed)
+    {
+        for (auto& word : m_state)
+        {
+            word = mixSeed(seed);
+            seed += 0x9E3779B97F4A7C15ull;
+        }
+    }
+
+    // Следующее 64-битное значение
+    std::uint64_t next()
+    {
+        const std::uint64_t result = rotl(m_state[1] * 5, 7) * 9;
+        const std::uint64_t t = m_state[1] << 17;
+
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+
+        return result;
+    }
+
+    // Следующее 32-битное значение
+    std::uint32_t nextUInt32()
+    {
+        return static_cast<std::uint32_t>(next() >> 32);
+    }
+
+    // Равномерное число в [0, 1) с 53 значащими битами
+    double nextDouble()
+    {
+        return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // Равномерное целое в [0, bound) (bound > 0), без деления (метод Лемира)
+    std::uint32_t nextBelow(std::uint32_t bound)
+    {
+        return static_cast<std::uint32_t>((static_cast<std::uint64_t>(nextUInt32()) * bound) >> 32);
+    }
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    std::uint64_t m_state[4]; // Состояние генератора
+};
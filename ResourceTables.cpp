@@ -0,0 +1,194 @@
+#include "ResourceTables.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "Random.h"
+
+namespace
+{
+    const int VeinSamples = 256;      // Жил, по которым оценивается среднее число клеток жилы
+    const int ConflictSamples = 4096; // Кандидатов, по которым оценивается число близких соседей
+
+    // Оценить среднее число разных клеток, которые проходит жила с длиной блуждания от minSize до maxSize
+    // (то же блуждание, что и в generateOreVeins; зерно постоянное, поэтому оценка одна и та же при каждой загрузке)
+    double meanVeinCells(int minSize, int maxSize)
+    {
+        RandomStream random(deriveSeed(0, static_cast<std::uint64_t>(minSize) << 32 | static_cast<std::uint32_t>(maxSize)));
+        std::vector<std::uint64_t> cells;
+        double total = 0.0;
+        for (int sample = 0; sample < VeinSamples; ++sample)
+        {
+            int size = minSize + static_cast<int>(random.nextBelow(static_cast<std::uint32_t>(maxSize - minSize + 1)));
+            std::uint32_t x = 0;
+            std::uint32_t y = 0;
+            cells.clear();
+            for (int step = 0; step < size; ++step)
+            {
+                cells.push_back(static_cast<std::uint64_t>(x) << 32 | y);
+                switch (random.nextBelow(4))
+                {
+                case 0: ++x; break;
+                case 1: --x; break;
+                case 2: ++y; break;
+                default: --y; break;
+                }
+            }
+            std::sort(cells.begin(), cells.end());
+            total += static_cast<double>(std::unique(cells.begin(), cells.end()) - cells.begin());
+        }
+        return total / VeinSamples;
+    }
+
+    // Оценить, сколько в среднем кандидатов соседних клеток решётки с шагом spacing оказываются ближе spacing к кандидату
+    // (если оставлять всех; точки целые, как в generateOreVeins)
+    double meanConflicts(int spacing)
+    {
+        RandomStream random(deriveSeed(1, static_cast<std::uint64_t>(spacing)));
+        const std::uint32_t step = static_cast<std::uint32_t>(spacing);
+        const std::int64_t minDistance2 = static_cast<std::int64_t>(spacing) * spacing;
+        int conflicts = 0;
+        for (int sample = 0; sample < ConflictSamples; ++sample)
+        {
+            std::int64_t x = static_cast<std::int64_t>(random.nextBelow(step));
+            std::int64_t y = static_cast<std::int64_t>(random.nextBelow(step));
+            for (int dy = -1; dy <= 1; ++dy)
+            {
+                for (int dx = -1; dx <= 1; ++dx)
+                {
+                    if (dx == 0 && dy == 0)
+                        continue;
+                    std::int64_t distanceX = dx * spacing + static_cast<std::int64_t>(random.nextBelow(step)) - x;
+                    std::int64_t distanceY = dy * spacing + static_cast<std::int64_t>(random.nextBelow(step)) - y;
+                    conflicts += distanceX * distanceX + distanceY * distanceY < minDistance2;
+                }
+            }
+        }
+        return static_cast<double>(conflicts) / ConflictSamples;
+    }
+
+    // Вероятность оставить кандидата, при которой после разноса остаётся доля затравок seeds на клетку решётки.
+    // Если оставлять долю q, то рядом с кандидатом в среднем conflicts * q соседей, и он сильнее всех n соседей
+    // с вероятностью 1 / (n + 1); для пуассоновского n затравок остаётся (1 - exp(-conflicts * q)) / conflicts.
+    // Больше, чем при q = 1, разнос не допускает
+    double seedChanceFor(double seeds, double conflicts)
+    {
+        if (conflicts < 1e-9)
+            return std::min(1.0, seeds);
+        if (seeds * conflicts >= 1.0 - std::exp(-conflicts))
+            return 1.0;
+        return -std::log(1.0 - conflicts * seeds) / conflicts;
+    }
+}
+
+// Проверить параметры руды (исключение std::invalid_argument, если они неверны)
+void validateResourceDefinition(const ResourceDefinition& resource)
+{
+    std::string tile = std::to_string(resource.tile);
+    if (!(resource.top >= 0.0 && resource.top <= resource.bottom && resource.bottom <= 100.0))
+    {
+        throw std::invalid_argument("Invalid depth range of resource tile " + tile);
+    }
+    if (!(resource.chanceTop >= 0.0 && resource.chanceTop <= 100.0 && resource.chanceBottom >= 0.0 && resource.chanceBottom <= 100.0))
+    {
+        throw std::invalid_argument("Invalid chance of resource tile " + tile);
+    }
+    if (resource.veinSpacing < 1 || resource.veinMinSize < 1 || resource.veinMinSize > resource.veinMaxSize)
+    {
+        throw std::invalid_argument("Invalid vein size of resource tile " + tile);
+    }
+}
+
+// Скомпилировать описания для мира высотой worldHeight
+ResourceTables::ResourceTables(const std::vector<ResourceDefinition>& resources, int worldHeight)
+    : m_worldHeight(worldHeight)
+    , m_rows(static_cast<std::size_t>(std::max(0, worldHeight)))
+    , m_maxVeinSize(0)
+{
+    if (worldHeight <= 0)
+    {
+        throw std::invalid_argument("Invalid world height");
+    }
+    for (const ResourceDefinition& resource : resources)
+    {
+        validateResourceDefinition(resource);
+    }
+
+    // Руды проверяются по очереди и занимают только оставшийся камень, поэтому руда i
+    // достаётся клетке камня с вероятностью p_i * (1 - p_0) * ... * (1 - p_(i-1)).
+    // Для каждой строки эти вероятности накапливаются в таблицу заранее, и клетке нужно
+    // одно случайное число и поиск по таблице вместо прохода по каждой руде
+    for (int y = 0; y < worldHeight; ++y)
+    {
+        double heightPercent = 100.0 * y / worldHeight;
+        ResourceRow& table = m_rows[y];
+        double stoneLeft = 1.0;
+
+        for (const ResourceDefinition& resource : resources)
+        {
+            if (heightPercent < resource.top || heightPercent > resource.bottom)
+                continue;
+            if (table.count == MaxRowResources)
+            {
+                throw std::invalid_argument("More than " + std::to_string(MaxRowResources) + " resources at row " + std::to_string(y));
+            }
+
+            // Шанс меняется линейно от начала диапазона к концу
+            double range = resource.bottom - resource.top;
+            double position = range > 0.0 ? (heightPercent - resource.top) / range : 0.0;
+            double chance = (resource.chanceTop + (resource.chanceBottom - resource.chanceTop) * position) / 100.0;
+            table.total += stoneLeft * chance;
+            stoneLeft *= 1.0 - chance;
+
+            table.cumulative[table.count] = table.total;
+            table.tiles[table.count] = resource.tile;
+            ++table.count;
+        }
+    }
+
+    // Шанс руды задаёт и плотность жил: кандидатов в затравки - по одному на клетку решётки spacing x spacing,
+    // и доля оставленных подбирается так, чтобы жилы покрывали в среднем ту же долю камня, что и при размещении по клеткам
+    // (пока хватает разноса: при большем шансе жил столько, сколько он позволяет)
+    for (const ResourceDefinition& resource : resources)
+    {
+        double seedsPerChance = static_cast<double>(resource.veinSpacing) * resource.veinSpacing
+            / meanVeinCells(resource.veinMinSize, resource.veinMaxSize) / 100.0;
+        double conflicts = meanConflicts(resource.veinSpacing);
+        VeinType vein;
+        vein.tile = resource.tile;
+        vein.top = static_cast<int>(worldHeight * resource.top / 100.0);
+        vein.bottom = static_cast<int>(worldHeight * resource.bottom / 100.0);
+        vein.spacing = resource.veinSpacing;
+        vein.minSize = resource.veinMinSize;
+        vein.maxSize = resource.veinMaxSize;
+        for (int y = vein.top; y < vein.bottom; ++y)
+        {
+            double range = resource.bottom - resource.top;
+            double position = range > 0.0 ? (100.0 * y / worldHeight - resource.top) / range : 0.0;
+            double chance = resource.chanceTop + (resource.chanceBottom - resource.chanceTop) * position;
+            vein.seedChance.push_back(static_cast<float>(seedChanceFor(chance * seedsPerChance, conflicts)));
+        }
+        m_veins.push_back(vein);
+        m_maxVeinSize = std::max(m_maxVeinSize, vein.maxSize);
+    }
+}
+
+// Получить высоту мира, для которой скомпилированы таблицы
+int ResourceTables::getWorldHeight() const
+{
+    return m_worldHeight;
+}
+
+// Получить параметры жил руд в порядке описаний
+const std::vector<VeinType>& ResourceTables::getVeins() const
+{
+    return m_veins;
+}
+
+// Получить наибольшую длину блуждания среди всех руд
+int ResourceTables::getMaxVeinSize() const
+{
+    return m_maxVeinSize;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "TileGrid.h"
+
+// Описание руды (из файла определений)
+struct ResourceDefinition
+{
+    TileId tile = 0;           // Тайл руды
+    double top = 0.0;          // Начало диапазона глубин (процент высоты мира)
+    double bottom = 0.0;       // Конец диапазона глубин (процент высоты мира)
+    double chanceTop = 0.0;    // Шанс клетки камня стать рудой в начале диапазона (процент; для жил - через плотность затравок)
+    double chanceBottom = 0.0; // Шанс в конце диапазона (между концами меняется линейно)
+    int veinSpacing = 1;       // Наименьшее расстояние между затравками жил (тайлы)
+    int veinMinSize = 1;       // Наименьшая длина блуждания жилы (тайлы)
+    int veinMaxSize = 1;       // Наибольшая длина блуждания жилы (тайлы)
+};
+
+// Проверить параметры руды (исключение std::invalid_argument, если они неверны)
+void validateResourceDefinition(const ResourceDefinition& resource);
+
+const int MaxRowResources = 8; // Наибольшее число руд, чьи диапазоны глубин пересекают одну строку
+
+// Накопленные вероятности руд одной строки в порядке их проверки
+struct ResourceRow
+{
+    int count = 0;                                  // Число руд в строке
+    double total = 0.0;                             // Вероятность, что камень станет какой-либо рудой
+    std::array<double, MaxRowResources> cumulative; // Накопленные вероятности
+    std::array<TileId, MaxRowResources> tiles;      // Тайлы руд
+};
+
+// Параметры жил одной руды с диапазоном глубин в строках мира
+struct VeinType
+{
+    TileId tile;       // Тайл руды
+    int top;           // Первая строка диапазона глубин
+    int bottom;        // Строка за концом диапазона глубин
+    int spacing;       // Наименьшее расстояние между затравками жил (тайлы)
+    int minSize;       // Наименьшая длина блуждания (тайлы)
+    int maxSize;       // Наибольшая длина блуждания (тайлы)
+    std::vector<float> seedChance; // Вероятность оставить кандидата в затравки по строкам диапазона (по шансу руды)
+};
+
+// Описания руд, скомпилированные для мира заданной высоты в плоские таблицы: генератор
+// берёт готовую строку таблицы по глубине, а не пересчитывает диапазоны и шансы для каждой клетки
+class ResourceTables
+{
+public:
+    // Скомпилировать описания для мира высотой worldHeight.
+    // Исключение, если параметры руды неверны или диапазоны глубин пересекают одну строку больше MaxRowResources раз
+    ResourceTables(const std::vector<ResourceDefinition>& resources, int worldHeight);
+
+    // Получить высоту мира, для которой скомпилированы таблицы
+    int getWorldHeight() const;
+    // Получить таблицу строки мира (без проверок, 0 <= y < getWorldHeight())
+    const ResourceRow& getRow(int y) const { return m_rows[y]; }
+    // Получить параметры жил руд в порядке описаний
+    const std::vector<VeinType>& getVeins() const;
+    // Получить наибольшую длину блуждания среди всех руд (на столько жила уходит от затравки)
+    int getMaxVeinSize() const;
+
+private:
+    int m_worldHeight;               // Высота мира
+    std::vector<ResourceRow> m_rows; // Таблицы по строкам мира
+    std::vector<VeinType> m_veins;   // Жилы руд
+    int m_maxVeinSize;               // Наибольшая длина блуждания
+};
@@ -0,0 +1,139 @@
+#include "Resources.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+// Получить текстуру по имени
+sf::Texture& Resources::getTexture(const std::string& name)
+{
+    return m_textures.at(name);
+}
+
+// Загрузить текстуру из файла
+void Resources::loadTexture(const std::string& name, const std::string& filePath)
+{
+    sf::Texture texture;
+    if (!texture.loadFromFile(filePath))
+    {
+        throw std::runtime_error("Failed to load texture: " + filePath);
+    }
+    m_textures[name] = texture;
+}
+
+// Загрузить изображение тайла для упаковки в атлас
+void Resources::loadAtlasImage(int tileId, const std::string& filePath)
+{
+    sf::Image image;
+    if (!image.loadFromFile(filePath))
+    {
+        throw std::runtime_error("Failed to load image: " + filePath);
+    }
+    m_atlasImages[tileId] = image;
+}
+
+// Упаковать загруженные изображения в одну или несколько текстур атласа.
+// Каждый тайл занимает ячейку tileSize x tileSize (левый верхний угол изображения,
+// как и у отдельного спрайта) с рамкой padding, в которую продублированы крайние
+// пиксели, чтобы при масштабировании соседние тайлы не просвечивали.
+void Resources::buildAtlas(int tileSize, int padding)
+{
+    if (tileSize <= 0 || padding < 0)
+    {
+        throw std::invalid_argument("Invalid atlas tile size or padding");
+    }
+
+    m_atlasPages.clear();
+    m_atlasRegions.clear();
+    if (m_atlasImages.empty())
+    {
+        return;
+    }
+
+    int cellSize = tileSize + 2 * padding;
+    int maxPageSize = static_cast<int>(std::min(sf::Texture::getMaximumSize(), 4096u));
+    int cellsPerRow = maxPageSize / cellSize;
+    if (cellsPerRow <= 0)
+    {
+        throw std::runtime_error("Atlas cell does not fit into a texture");
+    }
+    int cellsPerPage = cellsPerRow * cellsPerRow;
+
+    // Квадратная страница минимального размера, вмещающая оставшиеся изображения
+    auto pageColumns = [&](int count)
+    {
+        int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(count))));
+        return std::min(columns, cellsPerRow);
+    };
+
+    auto it = m_atlasImages.begin();
+    int remaining = static_cast<int>(m_atlasImages.size());
+    while (remaining > 0)
+    {
+        int count = std::min(remaining, cellsPerPage);
+        int columns = pageColumns(count);
+        int rows = (count + columns - 1) / columns;
+
+        sf::Image page;
+        page.create(columns * cellSize, rows * cellSize, sf::Color::Transparent);
+
+        int pageIndex = static_cast<int>(m_atlasPages.size());
+        for (int cell = 0; cell < count; ++cell, ++it)
+        {
+            const sf::Image& source = it->second;
+            sf::Vector2u sourceSize = source.getSize();
+            int cellX = (cell % columns) * cellSize;
+            int cellY = (cell / columns) * cellSize;
+
+            // Скопировать тайл вместе с рамкой, ограничивая координаты краями тайла
+            int maxX = std::min(tileSize, static_cast<int>(sourceSize.x)) - 1;
+            int maxY = std::min(tileSize, static_cast<int>(sourceSize.y)) - 1;
+            for (int y = -padding; y < tileSize + padding; ++y)
+            {
+                for (int x = -padding; x < tileSize + padding; ++x)
+                {
+                    unsigned int sourceX = static_cast<unsigned int>(std::max(0, std::min(x, maxX)));
+                    unsigned int sourceY = static_cast<unsigned int>(std::max(0, std::min(y, maxY)));
+                    page.setPixel(cellX + padding + x, cellY + padding + y, source.getPixel(sourceX, sourceY));
+                }
+            }
+
+            AtlasRegion region;
+            region.page = pageIndex;
+            region.rect = sf::IntRect(cellX + padding, cellY + padding, tileSize, tileSize);
+            m_atlasRegions[it->first] = region;
+        }
+
+        std::unique_ptr<sf::Texture> texture(new sf::Texture());
+        if (!texture->loadFromImage(page))
+        {
+            throw std::runtime_error("Failed to create atlas texture");
+        }
+        m_atlasPages.push_back(std::move(texture));
+        remaining -= count;
+    }
+}
+
+// Получить количество страниц атласа
+int Resources::getAtlasPageCount() const
+{
+    return static_cast<int>(m_atlasPages.size());
+}
+
+// Получить текстуру страницы атласа
+const sf::Texture& Resources::getAtlasTexture(int page) const
+{
+    return *m_atlasPages.at(page);
+}
+
+// Получить область атласа по индексу тайла
+const AtlasRegion& Resources::getAtlasRegion(int tileId) const
+{
+    auto it = m_atlasRegions.find(tileId);
+    if (it == m_atlasRegions.end())
+    {
+        throw std::out_of_range("Tile is not in the atlas: " + std::to_string(tileId));
+    }
+    return it->second;
+}
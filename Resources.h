@@ -0,0 +1,41 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Область атласа: номер страницы и прямоугольник на ней
+struct AtlasRegion
+{
+    int page = -1;    // Номер страницы атласа
+    sf::IntRect rect; // Прямоугольник тайла на странице
+};
+
+// Класс для управления ресурсами (текстурами)
+class Resources
+{
+public:
+    // Получить текстуру по имени
+    sf::Texture& getTexture(const std::string& name);
+    // Загрузить текстуру из файла
+    void loadTexture(const std::string& name, const std::string& filePath);
+
+    // Загрузить изображение тайла для упаковки в атлас
+    void loadAtlasImage(int tileId, const std::string& filePath);
+    // Упаковать загруженные изображения в одну или несколько текстур атласа
+    void buildAtlas(int tileSize, int padding = 1);
+    // Получить количество страниц атласа
+    int getAtlasPageCount() const;
+    // Получить текстуру страницы атласа
+    const sf::Texture& getAtlasTexture(int page) const;
+    // Получить область атласа по индексу тайла
+    const AtlasRegion& getAtlasRegion(int tileId) const;
+
+private:
+    std::map<std::string, sf::Texture> m_textures;          // Хранилище текстур
+    std::map<int, sf::Image> m_atlasImages;                 // Изображения, ожидающие упаковки
+    std::vector<std::unique_ptr<sf::Texture>> m_atlasPages; // Страницы атласа
+    std::map<int, AtlasRegion> m_atlasRegions;              // Области атласа по индексу тайла
+};
@@ -0,0 +1,219 @@
+#include "TerrainGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "OreVeins.h"
+#include "Random.h"
+#include "ThreadPool.h"
+
+namespace
+{
+    // Найти ресурс строки по числу roll из [0, total)
+    int findResource(const ResourceRow& table, double roll)
+    {
+        int k = 0;
+        while (k + 1 < table.count && roll >= table.cumulative[k])
+        {
+            ++k;
+        }
+        return k;
+    }
+
+    // Разместить руды в столбцах [begin, end) карты, чья первая строка - строка мира originY, по таблицам строк
+    void placeResources(TileGrid& tileMap, int begin, int end, int originY, const ResourceTables& resources,
+        RandomStream& random, ResourcePlacement placement)
+    {
+        if (originY < 0 || originY + tileMap.getHeight() > resources.getWorldHeight())
+        {
+            throw std::invalid_argument("Resource tables do not cover the tile map rows");
+        }
+        for (int y = 0; y < tileMap.getHeight(); ++y)
+        {
+            const ResourceRow& table = resources.getRow(originY + y);
+            if (table.count == 0)
+                continue;
+
+            TileSpan<TileId> row = tileMap.row(y);
+            if (placement == ResourcePlacement::SkipSampling)
+            {
+                // Попадания в строке - независимые испытания с вероятностью total на клетку,
+                // поэтому расстояние до следующего попадания распределено геометрически.
+                // Испытание проводится для любой клетки, а ресурс ставится только в камень:
+                // для клеток камня распределение то же, что и при проверке каждой клетки
+                if (table.total <= 0.0)
+                    continue;
+
+                double invLogMiss = 1.0 / std::log1p(-table.total);
+                int x = begin;
+                for (;;)
+                {
+                    double gap = std::floor(std::log(1.0 - random.nextDouble()) * invLogMiss);
+                    if (!(gap < end - x)) // Также отбрасывает бесконечность и NaN
+                        break;
+                    x += static_cast<int>(gap);
+
+                    double roll = random.nextDouble() * table.total;
+                    if (row[x] == RockTile) // Только камень
+                    {
+                        row[x] = table.tiles[findResource(table, roll)]; // Заменить на ресурс
+                    }
+                    ++x;
+                }
+                continue;
+            }
+
+            for (int x = begin; x < end; ++x)
+            {
+                if (row[x] != RockTile) // Только камень
+                    continue;
+
+                double roll = random.nextDouble();
+                if (roll >= table.total)
+                    continue;
+
+                row[x] = table.tiles[findResource(table, roll)]; // Заменить на ресурс
+            }
+        }
+    }
+
+    // Заполнить столбцы [begin, end) карты по карте высот (originY - строка мира первой строки карты)
+    void fillTerrain(TileGrid& tileMap, int begin, int end, int originY, const std::vector<int>& heightMap)
+    {
+        // Столбец рельефа - три серии, поэтому он строится сериями и распаковывается построчно
+        generateTerrainColumns(heightMap, begin, end, originY, tileMap.getHeight()).decode(tileMap, begin);
+    }
+}
+
+/**
+ * Generates a height map using Perlin noise algorithm.
+ *
+ * @param noise the seeded noise generator
+ * @param width the width of the height map
+ * @param height the height of the height map
+ * @param scale the noise frequency per tile of the first octave
+ * @param numOctaves the number of octaves for noise generation
+ * @param persistence the persistence value for noise generation
+ * @param originX the noise lattice column of the first height map column
+ * @param originY the noise lattice row sampled by every column
+ * @param pool the thread pool for column bands, or nullptr to generate serially
+ *
+ * @return a vector of integers representing the generated height map
+ *
+ * @throws None
+ */
+std::vector<int> generateHeightMap(const NoiseEngine& noise, int width, int height, double scale, int numOctaves, double persistence, std::int64_t originX, std::int64_t originY, ThreadPool* pool)
+{
+    std::vector<int> heightMap(width);
+    std::vector<float> noiseValues(width);
+
+    // Шум считается пакетно в float (векторные инструкции, если они есть у процессора) по целым номерам столбцов;
+    // значение столбца зависит только от его номера, поэтому полосы дают тот же результат, что и один проход
+    auto generateBand = [&](int begin, int end)
+    {
+        noise.fbm2DRow(originX + begin, originY, scale, noiseValues.data() + begin, end - begin, numOctaves, static_cast<float>(persistence));
+
+        for (int i = begin; i < end; i++)
+        {
+            heightMap[i] = static_cast<int>((noiseValues[i] + 1) * 0.5 * height);
+        }
+    };
+
+    if (pool)
+        pool->parallelFor(width, GenerationBandSize, generateBand);
+    else
+        generateBand(0, width);
+
+    return heightMap;
+}
+
+// Создать карту тайлов по карте высот: небо, два ряда земли с травой, ниже камень
+TileGrid generateTerrain(int width, int height, const std::vector<int>& heightMap, ThreadPool* pool)
+{
+    TileGrid tileMap(width, height);
+    auto generateBand = [&](int begin, int end)
+    {
+        fillTerrain(tileMap, begin, end, 0, heightMap);
+    };
+
+    if (pool)
+        pool->parallelFor(width, GenerationBandSize, generateBand);
+    else
+        generateBand(0, width);
+
+    return tileMap;
+}
+
+// Заполнить участок мира по карте высот его столбцов (originY - строка мира первой строки участка)
+void generateTerrain(TileGrid& region, int originY, const std::vector<int>& heightMap)
+{
+    fillTerrain(region, 0, region.getWidth(), originY, heightMap);
+}
+
+// Создать столбцы рельефа heightMap[begin..end) сериями (по три на столбец) для строк мира [originY, originY + height)
+TileColumns generateTerrainColumns(const std::vector<int>& heightMap, int begin, int end, int originY, int height)
+{
+    TileColumns columns(height);
+    for (int x = begin; x < end; ++x)
+    {
+        // Небо выше поверхности, два ряда земли с травой, ниже камень (границы обрезаются участком)
+        int grassTop = std::min(std::max(heightMap[x] - originY, 0), height);
+        int rockTop = std::min(std::max(heightMap[x] + 2 - originY, 0), height);
+        const TileRun runs[] =
+        {
+            { SkyTile, grassTop },             // Небо
+            { GrassTile, rockTop - grassTop }, // Земля с травой
+            { RockTile, height - rockTop }     // Камень
+        };
+        columns.addColumn(runs, 3);
+    }
+    return columns;
+}
+
+void generateUndergroundResources(TileGrid& tileMap, int NumTilesX, int NumTilesY, const ResourceTables& resources, std::uint64_t worldSeed, ResourcePlacement placement, ThreadPool* pool)
+{
+    if (resources.getWorldHeight() != NumTilesY)
+    {
+        throw std::invalid_argument("Resource tables are compiled for another world height");
+    }
+    if (placement == ResourcePlacement::Veins)
+    {
+        // Работа жил пропорциональна объёму руды, делить карту на полосы незачем
+        generateOreVeins(tileMap, 0, 0, resources, worldSeed);
+        return;
+    }
+
+    const std::uint64_t resourceSeed = deriveSeed(worldSeed, ResourceStream);
+
+    // Каждая полоса столбцов берёт свой поток случайных чисел,
+    // поэтому полосы можно обрабатывать в любом порядке и на любых потоках
+    auto generateBand = [&](int begin, int end)
+    {
+        RandomStream random(deriveSeed(resourceSeed, static_cast<std::uint64_t>(begin / GenerationBandSize)));
+        placeResources(tileMap, begin, end, 0, resources, random, placement);
+    };
+
+    if (pool)
+    {
+        pool->parallelFor(NumTilesX, GenerationBandSize, generateBand);
+    }
+    else
+    {
+        // Те же полосы по порядку, чтобы потоки случайных чисел совпадали
+        for (int begin = 0; begin < NumTilesX; begin += GenerationBandSize)
+        {
+            generateBand(begin, std::min(begin + GenerationBandSize, NumTilesX));
+        }
+    }
+}
+
+// Разместить руды по таблицам resources в участке мира, начинающемся со строки мира originY
+void generateUndergroundResources(TileGrid& region, int originY, const ResourceTables& resources, RandomStream& random, ResourcePlacement placement)
+{
+    if (placement == ResourcePlacement::Veins)
+    {
+        throw std::invalid_argument("Ore veins need the region position, use generateOreVeins");
+    }
+    placeResources(region, 0, region.getWidth(), originY, resources, random, placement);
+}
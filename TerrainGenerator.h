@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "NoiseEngine.h"
+#include "ResourceTables.h"
+#include "TileColumns.h"
+#include "TileGrid.h"
+
+class RandomStream;
+class ThreadPool;
+
+const int GenerationBandSize = 256; // Ширина полосы столбцов при параллельной генерации
+
+// Тайлы, которые ставит генератор рельефа (файл определений обязан объявить их под этими индексами)
+const TileId GrassTile = 0; // Земля с травой
+const TileId SkyTile = 1;   // Небо (и пустота пещер)
+const TileId RockTile = 2;  // Камень, в котором лежат пещеры и руды
+
+// Ключи независимых потоков случайных чисел, выводимых из зерна мира
+enum RandomStreamKey : std::uint64_t
+{
+    WorldLayoutStream = 1,   // Зерно шума и смещения карты высот
+    ResourceStream = 2,      // Размещение руд на всей карте (далее по полосе столбцов)
+    ChunkResourceStream = 3, // Размещение руд в чанках мира (далее по координатам чанка)
+    CaveStream = 4,          // Начальный шум пещер (далее по слову битовой доски и строке мира)
+    OreVeinStream = 5        // Затравки и блуждание жил (далее по руде и клетке решётки затравок)
+};
+
+// Создать карту высот по шуму: столбец i берёт шум столбца решётки originX + i в строке originY
+// (pool - пул потоков для полос столбцов или nullptr)
+std::vector<int> generateHeightMap(const NoiseEngine& noise, int width, int height, double scale, int numOctaves, double persistence,
+    std::int64_t originX, std::int64_t originY, ThreadPool* pool = nullptr);
+// Создать карту тайлов по карте высот (pool - пул потоков для полос столбцов или nullptr)
+TileGrid generateTerrain(int width, int height, const std::vector<int>& heightMap, ThreadPool* pool = nullptr);
+// Заполнить участок мира по карте высот его столбцов (originY - строка мира первой строки участка)
+void generateTerrain(TileGrid& region, int originY, const std::vector<int>& heightMap);
+// Создать столбцы рельефа heightMap[begin..end) сериями (по три на столбец) для строк мира [originY, originY + height)
+TileColumns generateTerrainColumns(const std::vector<int>& heightMap, int begin, int end, int originY, int height);
+// Способ выбора клеток для руды (у PerCell и SkipSampling распределение руд одинаковое, карты при одном зерне - разные)
+enum class ResourcePlacement
+{
+    PerCell,      // Случайное число для каждой клетки камня
+    SkipSampling, // Прыжок сразу к следующему попаданию, стоимость пропорциональна числу руд
+    Veins         // Жилы вокруг разнесённых затравок (generateOreVeins), распределение руд другое
+};
+
+// Разместить руды по таблицам resources (скомпилированным для высоты NumTilesY) в камне под поверхностью;
+// результат определяется зерном мира и не зависит от числа потоков (pool - пул потоков для полос столбцов или nullptr)
+void generateUndergroundResources(TileGrid& tileMap, int NumTilesX, int NumTilesY, const ResourceTables& resources, std::uint64_t worldSeed,
+    ResourcePlacement placement = ResourcePlacement::PerCell, ThreadPool* pool = nullptr);
+// Разместить руды по таблицам resources в участке мира, начинающемся со строки мира originY
+// (жилам нужно и положение участка по горизонтали, для них есть generateOreVeins)
+void generateUndergroundResources(TileGrid& region, int originY, const ResourceTables& resources, RandomStream& random, ResourcePlacement placement);
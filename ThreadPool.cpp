@@ -0,0 +1,148 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+// Создать пул (0 - по числу аппаратных потоков)
+ThreadPool::ThreadPool(unsigned threadCount) : m_stopping(false)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (unsigned i = 0; i < threadCount; ++i)
+    {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+// Дождаться завершения работающих задач и остановить потоки
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+        m_tasks.clear();
+    }
+    m_condition.notify_all();
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+// Получить количество рабочих потоков
+unsigned ThreadPool::getThreadCount() const
+{
+    return static_cast<unsigned>(m_workers.size());
+}
+
+// Поставить задачу в очередь; завершение задачи и её исключение можно получить из возвращённого future
+std::future<void> ThreadPool::submit(std::function<void()> task)
+{
+    // packaged_task сохраняет исключение задачи в future; std::function нужен копируемый объект,
+    // поэтому задача хранится через shared_ptr
+    auto packaged = std::make_shared<std::packaged_task<void()>>(std::move(task));
+    std::future<void> result = packaged->get_future();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back([packaged] { (*packaged)(); });
+    }
+    m_condition.notify_one();
+    return result;
+}
+
+// Разбить диапазон [0, count) на полосы по bandSize, выполнить func(begin, end) для каждой
+// полосы на потоках пула и вызывающем потоке и дождаться завершения всех полос
+void ThreadPool::parallelFor(int count, int bandSize, const std::function<void(int, int)>& func)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+    bandSize = std::max(1, bandSize);
+    int bandCount = (count + bandSize - 1) / bandSize;
+
+    // Общее состояние живёт, пока его держит хотя бы один исполнитель: помощник,
+    // до которого очередь дошла после завершения всех полос, просто выходит
+    struct Shared
+    {
+        std::atomic<int> nextBand{ 0 };
+        std::mutex mutex;
+        std::condition_variable done;
+        int finishedBands = 0;
+        std::exception_ptr error;
+    };
+    auto shared = std::make_shared<Shared>();
+
+    // Исполнитель забирает полосы, пока они не закончатся, поэтому быстрые потоки
+    // берут больше полос и нагрузка выравнивается сама
+    auto runBands = [shared, count, bandSize, bandCount, &func]()
+    {
+        for (;;)
+        {
+            int band = shared->nextBand.fetch_add(1);
+            if (band >= bandCount)
+                break;
+
+            int finished = 1;
+            try
+            {
+                int begin = band * bandSize;
+                func(begin, std::min(begin + bandSize, count));
+            }
+            catch (...)
+            {
+                // Остальные полосы не запускать и считать завершёнными
+                int firstSkipped = shared->nextBand.exchange(bandCount);
+                if (firstSkipped < bandCount)
+                    finished += bandCount - firstSkipped;
+
+                std::lock_guard<std::mutex> lock(shared->mutex);
+                if (!shared->error)
+                    shared->error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(shared->mutex);
+            shared->finishedBands += finished;
+            if (shared->finishedBands == bandCount)
+                shared->done.notify_all();
+        }
+    };
+
+    int helpers = std::min(static_cast<int>(m_workers.size()), bandCount - 1);
+    for (int i = 0; i < helpers; ++i)
+    {
+        submit(runBands);
+    }
+    runBands();
+
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    shared->done.wait(lock, [&shared, bandCount] { return shared->finishedBands == bandCount; });
+    if (shared->error)
+    {
+        std::rethrow_exception(shared->error);
+    }
+}
+
+// Цикл рабочего потока
+void ThreadPool::workerLoop()
+{
+    for (;;)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+            if (m_stopping)
+                return;
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+
+        // Исключение задачи остаётся в её future (см. submit), из потока оно не вылетает
+        task();
+    }
+}
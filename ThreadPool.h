@@ -0,0 +1,41 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Пул рабочих потоков с очередью задач
+class ThreadPool
+{
+public:
+    // Создать пул (0 - по числу аппаратных потоков)
+    explicit ThreadPool(unsigned threadCount = 0);
+    // Дождаться завершения работающих задач и остановить потоки
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Получить количество рабочих потоков
+    unsigned getThreadCount() const;
+    // Поставить задачу в очередь; завершение задачи и её исключение можно получить из возвращённого future
+    // (задача, снятая с очереди при остановке пула, завершается с std::future_error)
+    std::future<void> submit(std::function<void()> task);
+    // Разбить диапазон [0, count) на полосы по bandSize, выполнить func(begin, end) для каждой
+    // полосы на потоках пула и вызывающем потоке и дождаться завершения всех полос
+    void parallelFor(int count, int bandSize, const std::function<void(int, int)>& func);
+
+private:
+    // Цикл рабочего потока
+    void workerLoop();
+
+    std::vector<std::thread> m_workers;        // Рабочие потоки
+    std::deque<std::function<void()>> m_tasks; // Очередь задач
+    std::mutex m_mutex;                        // Защита очереди
+    std::condition_variable m_condition;       // Сигнал о новой задаче или остановке
+    bool m_stopping;                           // Пул останавливается
+};
@@ -0,0 +1,201 @@
+#include "TileColumns.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    // Вызвать func(x) для каждого столбца, где тайл строки row отличается от тайла строки above.
+    // Строки сравниваются по 8 тайлов за раз: в рельефе почти все тайлы совпадают с верхними
+    template <typename Func>
+    void forEachChange(const TileId* above, const TileId* row, int width, Func func)
+    {
+        int x = 0;
+        for (; x + 8 <= width; x += 8)
+        {
+            std::uint64_t aboveWord, rowWord;
+            std::memcpy(&aboveWord, above + x, sizeof(aboveWord));
+            std::memcpy(&rowWord, row + x, sizeof(rowWord));
+            if (aboveWord == rowWord)
+                continue;
+            for (int i = x; i < x + 8; ++i)
+            {
+                if (row[i] != above[i])
+                    func(i);
+            }
+        }
+        for (; x < width; ++x)
+        {
+            if (row[x] != above[x])
+                func(x);
+        }
+    }
+}
+
+// Создать карту без столбцов с высотой столбца height
+TileColumns::TileColumns(int height) : m_height(height), m_columnStarts(1, 0)
+{
+    if (height < 0)
+    {
+        throw std::invalid_argument("Invalid column height");
+    }
+}
+
+// Сжать карту тайлов
+TileColumns::TileColumns(const TileGrid& tiles) : TileColumns(tiles.getHeight())
+{
+    int width = tiles.getWidth();
+    m_columnStarts.assign(static_cast<std::size_t>(width) + 1, 0);
+    if (width == 0 || m_height == 0)
+    {
+        return;
+    }
+
+    // Карта читается построчно в два прохода: сначала число серий каждого столбца
+    // (серия начинается там, где тайл отличается от тайла строкой выше), затем сами серии
+    std::vector<std::uint32_t> counts(width, 1);
+    for (int y = 1; y < m_height; ++y)
+    {
+        forEachChange(tiles.row(y - 1).data(), tiles.row(y).data(), width, [&](int x) { ++counts[x]; });
+    }
+    for (int x = 0; x < width; ++x)
+    {
+        m_columnStarts[x + 1] = m_columnStarts[x] + counts[x];
+    }
+
+    // Во втором проходе в length пишется строка начала серии, длины считаются в конце
+    m_runs.resize(m_columnStarts[width]);
+    std::vector<TileRun*> last(width);
+    TileSpan<const TileId> first = tiles.row(0);
+    for (int x = 0; x < width; ++x)
+    {
+        last[x] = m_runs.data() + m_columnStarts[x];
+        *last[x] = TileRun{ first[x], 0 };
+    }
+    for (int y = 1; y < m_height; ++y)
+    {
+        const TileId* row = tiles.row(y).data();
+        forEachChange(tiles.row(y - 1).data(), row, width, [&](int x) { *++last[x] = TileRun{ row[x], y }; });
+    }
+    for (int x = 0; x < width; ++x)
+    {
+        TileRun* runs = m_runs.data() + m_columnStarts[x];
+        int count = static_cast<int>(counts[x]);
+        for (int i = 0; i + 1 < count; ++i)
+        {
+            runs[i].length = runs[i + 1].length - runs[i].length;
+        }
+        runs[count - 1].length = m_height - runs[count - 1].length;
+    }
+}
+
+// Добавить столбец справа (соседние серии одного типа сливаются, сумма длин должна равняться высоте)
+void TileColumns::addColumn(const TileRun* runs, int count)
+{
+    std::size_t columnStart = m_runs.size();
+    int total = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        if (runs[i].length < 0)
+            throw std::invalid_argument("Negative tile run length");
+        if (runs[i].length == 0)
+            continue;
+
+        total += runs[i].length;
+        if (m_runs.size() > columnStart && m_runs.back().tile == runs[i].tile)
+            m_runs.back().length += runs[i].length;
+        else
+            m_runs.push_back(runs[i]);
+    }
+
+    if (total != m_height)
+    {
+        m_runs.resize(columnStart);
+        throw std::invalid_argument("Tile runs do not cover the column: " + std::to_string(total) + " of " + std::to_string(m_height));
+    }
+    m_columnStarts.push_back(static_cast<std::uint32_t>(m_runs.size()));
+}
+
+// Получить тайл (проход по сериям столбца)
+TileId TileColumns::get(int x, int y) const
+{
+    for (const TileRun& run : column(x))
+    {
+        if (y < run.length)
+            return run.tile;
+        y -= run.length;
+    }
+    throw std::out_of_range("Tile out of range: " + std::to_string(x) + ", " + std::to_string(y));
+}
+
+// Распаковать столбцы в карту тайлов начиная со столбца originX (высота карты равна высоте столбца)
+void TileColumns::decode(TileGrid& tiles, int originX) const
+{
+    int width = getWidth();
+    if (tiles.getHeight() != m_height || originX < 0 || originX + width > tiles.getWidth())
+    {
+        throw std::invalid_argument("Tile columns do not fit the tile grid");
+    }
+    if (m_height == 0)
+    {
+        return;
+    }
+
+    // Карта хранится построчно, поэтому запись идёт строками: текущие тайлы всех столбцов
+    // лежат в одной строке и копируются в каждую строку карты целиком, а меняются только
+    // на границах серий (событие "в строке y столбец x переходит на тип tile")
+    struct RunStart
+    {
+        int x;
+        TileId tile;
+    };
+    std::vector<std::uint32_t> eventStarts(static_cast<std::size_t>(m_height) + 1, 0);
+    for (int x = 0; x < width; ++x)
+    {
+        int y = 0;
+        for (const TileRun& run : column(x))
+        {
+            if (y > 0)
+                ++eventStarts[y + 1];
+            y += run.length;
+        }
+    }
+    for (int y = 0; y < m_height; ++y)
+    {
+        eventStarts[y + 1] += eventStarts[y];
+    }
+
+    std::vector<RunStart> events(eventStarts[m_height]);
+    std::vector<std::uint32_t> nextEvent(eventStarts.begin(), eventStarts.end() - 1);
+    std::vector<TileId> current(width);
+    for (int x = 0; x < width; ++x)
+    {
+        int y = 0;
+        for (const TileRun& run : column(x))
+        {
+            if (y > 0)
+                events[nextEvent[y]++] = RunStart{ x, run.tile };
+            else
+                current[x] = run.tile;
+            y += run.length;
+        }
+    }
+
+    for (int y = 0; y < m_height; ++y)
+    {
+        for (std::uint32_t i = eventStarts[y]; i < eventStarts[y + 1]; ++i)
+        {
+            current[events[i].x] = events[i].tile;
+        }
+        std::copy(current.begin(), current.end(), tiles.row(y).data() + originX);
+    }
+}
+
+// Распаковать в новую карту тайлов
+TileGrid TileColumns::toGrid() const
+{
+    TileGrid tiles(getWidth(), m_height);
+    decode(tiles);
+    return tiles;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "TileGrid.h"
+
+// Серия одинаковых тайлов в столбце (сверху вниз)
+struct TileRun
+{
+    TileId tile; // Тип тайла
+    int length;  // Количество тайлов подряд
+};
+
+// Карта, хранимая по столбцам сериями (тип, длина). Столбец рельефа - небо, земля с травой
+// и камень - укладывается в три серии вместо сотен тайлов, поэтому и генерация, и хранение
+// такого столбца стоят O(серий). Серии всех столбцов лежат в одном буфере, столбцы добавляются слева направо
+class TileColumns
+{
+public:
+    // Создать карту без столбцов с высотой столбца height
+    explicit TileColumns(int height = 0);
+    // Сжать карту тайлов
+    explicit TileColumns(const TileGrid& tiles);
+
+    // Получить количество столбцов
+    int getWidth() const { return static_cast<int>(m_columnStarts.size()) - 1; }
+    // Получить высоту столбца в тайлах
+    int getHeight() const { return m_height; }
+    // Получить общее количество серий
+    std::size_t getRunCount() const { return m_runs.size(); }
+
+    // Добавить столбец справа (соседние серии одного типа сливаются, сумма длин должна равняться высоте)
+    void addColumn(const TileRun* runs, int count);
+    // Получить серии столбца
+    TileSpan<const TileRun> column(int x) const
+    {
+        return TileSpan<const TileRun>(m_runs.data() + m_columnStarts[x], static_cast<int>(m_columnStarts[x + 1] - m_columnStarts[x]));
+    }
+    // Получить тайл (проход по сериям столбца)
+    TileId get(int x, int y) const;
+
+    // Распаковать столбцы в карту тайлов начиная со столбца originX (высота карты равна высоте столбца)
+    void decode(TileGrid& tiles, int originX = 0) const;
+    // Распаковать в новую карту тайлов
+    TileGrid toGrid() const;
+
+private:
+    int m_height;                             // Высота столбца в тайлах
+    std::vector<TileRun> m_runs;              // Серии всех столбцов подряд
+    std::vector<std::uint32_t> m_columnStarts; // Начало серий каждого столбца и конец последнего
+};
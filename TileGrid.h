@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Индекс типа тайла (типов тайлов немного, хватает одного байта)
+using TileId = std::uint8_t;
+
+// Непрерывный участок тайлов (строка карты)
+template <typename T>
+class TileSpan
+{
+public:
+    // Создать участок из указателя и длины
+    TileSpan(T* data, int size) : m_data(data), m_size(size) {}
+
+    T* begin() const { return m_data; }
+    T* end() const { return m_data + m_size; }
+    T* data() const { return m_data; }
+    int size() const { return m_size; }
+    T& operator[](int x) const { return m_data[x]; }
+
+private:
+    T* m_data;  // Первый тайл участка
+    int m_size; // Количество тайлов
+};
+
+// Карта тайлов: один непрерывный буфер индексов, хранимый построчно
+class TileGrid
+{
+public:
+    // Создать пустую карту
+    TileGrid() : m_width(0), m_height(0) {}
+    // Создать карту указанного размера, заполненную тайлом fill
+    TileGrid(int width, int height, TileId fill = 0)
+        : m_width(width), m_height(height), m_tiles(checkedSize(width, height), fill)
+    {
+    }
+
+    // Получить ширину карты в тайлах
+    int getWidth() const { return m_width; }
+    // Получить высоту карты в тайлах
+    int getHeight() const { return m_height; }
+    // Проверить, что координаты лежат внутри карты
+    bool contains(int x, int y) const { return x >= 0 && y >= 0 && x < m_width && y < m_height; }
+
+    // Получить тайл без проверки границ
+    TileId& operator()(int x, int y) { return m_tiles[index(x, y)]; }
+    TileId operator()(int x, int y) const { return m_tiles[index(x, y)]; }
+
+    // Получить тайл с проверкой границ
+    TileId& at(int x, int y)
+    {
+        check(x, y);
+        return m_tiles[index(x, y)];
+    }
+    TileId at(int x, int y) const
+    {
+        check(x, y);
+        return m_tiles[index(x, y)];
+    }
+
+    // Получить строку карты
+    TileSpan<TileId> row(int y) { return TileSpan<TileId>(m_tiles.data() + index(0, y), m_width); }
+    TileSpan<const TileId> row(int y) const { return TileSpan<const TileId>(m_tiles.data() + index(0, y), m_width); }
+
+    // Получить весь буфер тайлов
+    TileId* data() { return m_tiles.data(); }
+    const TileId* data() const { return m_tiles.data(); }
+    std::size_t size() const { return m_tiles.size(); }
+
+private:
+    std::size_t index(int x, int y) const { return static_cast<std::size_t>(y) * m_width + x; }
+
+    // Получить количество тайлов карты, проверив размер до выделения памяти
+    static std::size_t checkedSize(int width, int height)
+    {
+        if (width < 0 || height < 0)
+        {
+            throw std::invalid_argument("Invalid tile grid size");
+        }
+        return static_cast<std::size_t>(width) * height;
+    }
+
+    void check(int x, int y) const
+    {
+        if (!contains(x, y))
+        {
+            throw std::out_of_range("Tile out of range: " + std::to_string(x) + ", " + std::to_string(y));
+        }
+    }
+
+    int m_width;                 // Ширина карты в тайлах
+    int m_height;                // Высота карты в тайлах
+    std::vector<TileId> m_tiles; // Индексы тайлов (построчно)
+};
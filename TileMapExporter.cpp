@@ -0,0 +1,53 @@
+#include "TileMapExporter.h"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+    // Наибольшая длина индекса тайла с разделителем
+    const std::size_t MaxTileChars = std::numeric_limits<TileId>::digits10 + 2;
+}
+
+// Записать карту в файл (исключение, если файл не открылся или запись не удалась)
+void TileMapExporter::exportText(const TileGrid& tileMap, const std::string& path)
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open file for writing: " + path);
+    }
+
+    // В буфер помещается хотя бы одна строка карты целиком
+    const std::size_t maxRowChars = static_cast<std::size_t>(tileMap.getWidth()) * MaxTileChars + 1;
+    m_buffer.resize(std::max(BlockSize, maxRowChars));
+
+    char* const begin = m_buffer.data();
+    char* const end = begin + m_buffer.size();
+    char* out = begin;
+    for (int y = 0; y < tileMap.getHeight(); ++y)
+    {
+        if (static_cast<std::size_t>(end - out) < maxRowChars)
+        {
+            file.write(begin, out - begin);
+            out = begin;
+        }
+
+        for (TileId tileId : tileMap.row(y))
+        {
+            out = std::to_chars(out, end, tileId).ptr;
+            *out++ = ' ';
+        }
+        *out++ = '\n';
+    }
+    file.write(begin, out - begin);
+    file.close();
+
+    if (!file)
+    {
+        throw std::runtime_error("Failed to write file: " + path);
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "TileGrid.h"
+
+// Выгрузка карты тайлов в текстовый файл: индексы через пробел, одна строка карты на строку файла.
+// Строки форматируются в переиспользуемый буфер и пишутся большими блоками без сброса потока
+class TileMapExporter
+{
+public:
+    static const std::size_t BlockSize = 1 << 20; // Размер блока записи в байтах
+
+    // Записать карту в файл (исключение, если файл не открылся или запись не удалась)
+    void exportText(const TileGrid& tileMap, const std::string& path);
+
+private:
+    std::vector<char> m_buffer; // Буфер форматирования, сохраняется между выгрузками
+};
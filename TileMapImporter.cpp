@@ -0,0 +1,115 @@
+#include "TileMapImporter.h"
+
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "MappedFile.h"
+
+namespace
+{
+    // Пропустить пробелы и символы возврата каретки внутри строки
+    const char* skipSpaces(const char* first, const char* last)
+    {
+        while (first != last && (*first == ' ' || *first == '\t' || *first == '\r'))
+        {
+            ++first;
+        }
+        return first;
+    }
+
+    // Найти конец строки (символ '\n' или конец файла)
+    const char* findLineEnd(const char* first, const char* last)
+    {
+        const void* found = std::memchr(first, '\n', static_cast<std::size_t>(last - first));
+        return found ? static_cast<const char*>(found) : last;
+    }
+
+    // Проверить, что в строке нет ничего, кроме пробелов
+    bool isBlank(const char* first, const char* last)
+    {
+        return skipSpaces(first, last) == last;
+    }
+}
+
+// Прочитать карту из файла; размер карты берётся из файла (ширина - по первой строке).
+// Исключение, если строки разной длины, встретился не индекс или тип не зарегистрирован
+TileGrid TileMapImporter::importText(const std::string& path, const TileRegistry& tileRegistry) const
+{
+    MappedFile file(path);
+    const char* const begin = file.data();
+    const char* const end = begin + file.size();
+
+    // Первый проход: число непустых строк и ширина первой строки
+    int height = 0;
+    int width = 0;
+    for (const char* line = begin; line < end;)
+    {
+        const char* lineEnd = findLineEnd(line, end);
+        if (!isBlank(line, lineEnd))
+        {
+            if (height == 0)
+            {
+                for (const char* p = skipSpaces(line, lineEnd); p != lineEnd; p = skipSpaces(p, lineEnd))
+                {
+                    while (p != lineEnd && *p != ' ' && *p != '\t' && *p != '\r')
+                        ++p;
+                    ++width;
+                }
+            }
+            ++height;
+        }
+        line = lineEnd == end ? end : lineEnd + 1; // Указатель не уходит за конец файла, если последняя строка без перевода
+    }
+    if (width == 0 || height == 0)
+    {
+        throw std::runtime_error("Tile map file is empty: " + path);
+    }
+
+    // Какие индексы допустимы, считается один раз, а не для каждого тайла
+    bool registered[TileRegistry::MaxTileTypes];
+    for (int id = 0; id < TileRegistry::MaxTileTypes; ++id)
+    {
+        registered[id] = tileRegistry.isRegistered(id);
+    }
+
+    // Второй проход: разбор индексов прямо в строки карты
+    TileGrid tileMap(width, height);
+    int y = 0;
+    for (const char* line = begin; line < end;)
+    {
+        const char* lineEnd = findLineEnd(line, end);
+        if (!isBlank(line, lineEnd))
+        {
+            TileSpan<TileId> row = tileMap.row(y);
+            int x = 0;
+            for (const char* p = skipSpaces(line, lineEnd); p != lineEnd; p = skipSpaces(p, lineEnd))
+            {
+                unsigned value = 0;
+                std::from_chars_result result = std::from_chars(p, lineEnd, value);
+                if (result.ec != std::errc() || (result.ptr != lineEnd && *result.ptr != ' ' && *result.ptr != '\t' && *result.ptr != '\r'))
+                {
+                    throw std::runtime_error("Invalid tile id in " + path + " at line " + std::to_string(y + 1));
+                }
+                if (value >= static_cast<unsigned>(TileRegistry::MaxTileTypes) || !registered[value])
+                {
+                    throw std::runtime_error("Unknown tile id " + std::to_string(value) + " in " + path + " at line " + std::to_string(y + 1));
+                }
+                if (x == width)
+                {
+                    throw std::runtime_error("Line " + std::to_string(y + 1) + " of " + path + " is longer than the first line");
+                }
+                row[x++] = static_cast<TileId>(value);
+                p = result.ptr;
+            }
+            if (x != width)
+            {
+                throw std::runtime_error("Line " + std::to_string(y + 1) + " of " + path + " is shorter than the first line");
+            }
+            ++y;
+        }
+        line = lineEnd == end ? end : lineEnd + 1;
+    }
+    return tileMap;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <string>
+
+#include "TileGrid.h"
+#include "TileRegistry.h"
+
+// Загрузка карты тайлов из текстового файла, записанного TileMapExporter: файл отображается
+// в память и разбирается std::from_chars сразу в карту, без потоков ввода
+class TileMapImporter
+{
+public:
+    // Прочитать карту из файла; размер карты берётся из файла (ширина - по первой строке).
+    // Исключение, если строки разной длины, встретился не индекс или тип не зарегистрирован
+    TileGrid importText(const std::string& path, const TileRegistry& tileRegistry) const;
+};
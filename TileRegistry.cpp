@@ -0,0 +1,89 @@
+#include "TileRegistry.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+// Зарегистрировать тип тайла и получить его индекс
+TileId TileRegistry::registerType(const std::string& name, std::uint8_t flags, sf::Color color)
+{
+    if (std::find(m_names.begin(), m_names.end(), name) != m_names.end())
+    {
+        throw std::invalid_argument("Tile type already registered: " + name);
+    }
+    if (m_names.size() >= static_cast<std::size_t>(MaxTileTypes))
+    {
+        throw std::length_error("Too many tile types: " + name);
+    }
+
+    TileId id = static_cast<TileId>(m_names.size());
+    m_names.push_back(name);
+    m_types[id].color = color;
+    m_types[id].flags = flags;
+    return id;
+}
+
+// Задать текстуру и область текстуры для зарегистрированного типа
+void TileRegistry::setTexture(TileId id, const sf::Texture& texture, const sf::IntRect& rect)
+{
+    TileType& type = checkedType(id);
+    type.texture = &texture;
+    type.rect = rect;
+}
+
+// Получить индекс типа по имени
+TileId TileRegistry::getId(const std::string& name) const
+{
+    auto it = std::find(m_names.begin(), m_names.end(), name);
+    if (it == m_names.end())
+    {
+        throw std::out_of_range("Unknown tile type: " + name);
+    }
+    return static_cast<TileId>(it - m_names.begin());
+}
+
+// Получить имя типа по индексу
+const std::string& TileRegistry::getName(TileId id) const
+{
+    if (!isRegistered(id))
+    {
+        throw std::out_of_range("Unknown tile id: " + std::to_string(id));
+    }
+    return m_names[id];
+}
+
+// Получить количество зарегистрированных типов
+int TileRegistry::getCount() const
+{
+    return static_cast<int>(m_names.size());
+}
+
+// Проверить, что тип зарегистрирован
+bool TileRegistry::isRegistered(int id) const
+{
+    return id >= 0 && id < static_cast<int>(m_names.size());
+}
+
+// Проверить, что карта содержит только зарегистрированные типы
+void TileRegistry::validate(const TileGrid& tileMap) const
+{
+    // Индексы выдаются подряд, поэтому достаточно найти максимальный
+    const TileId* begin = tileMap.data();
+    const TileId* end = begin + tileMap.size();
+    const TileId* maxTile = std::max_element(begin, end);
+    if (maxTile != end && !isRegistered(*maxTile))
+    {
+        std::size_t offset = maxTile - begin;
+        throw std::runtime_error("Unknown tile id " + std::to_string(*maxTile)
+            + " at " + std::to_string(offset % tileMap.getWidth()) + ", " + std::to_string(offset / tileMap.getWidth()));
+    }
+}
+
+// Найти зарегистрированный тип или выбросить исключение
+TileType& TileRegistry::checkedType(TileId id)
+{
+    if (!isRegistered(id))
+    {
+        throw std::out_of_range("Unknown tile id: " + std::to_string(id));
+    }
+    return m_types[id];
+}
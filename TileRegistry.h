@@ -0,0 +1,59 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "TileGrid.h"
+
+// Флаги типа тайла
+enum TileFlags : std::uint8_t
+{
+    TileSolid = 1 << 0,    // Непроходимый тайл
+    TileMineable = 1 << 1, // Тайл можно выкопать
+    TileOre = 1 << 2       // Руда
+};
+
+// Данные отрисовки типа тайла
+struct TileType
+{
+    const sf::Texture* texture = nullptr; // Текстура (страница атласа), nullptr - тип не зарегистрирован
+    sf::IntRect rect;                     // Область текстуры
+    sf::Color color = sf::Color::White;   // Цвет вершин
+    std::uint8_t flags = 0;               // Флаги TileFlags
+};
+
+// Реестр типов тайлов: плотная таблица, индексируемая напрямую по TileId
+class TileRegistry
+{
+public:
+    static constexpr int MaxTileTypes = std::numeric_limits<TileId>::max() + 1; // Размер таблицы
+
+    // Зарегистрировать тип тайла и получить его индекс
+    TileId registerType(const std::string& name, std::uint8_t flags = 0, sf::Color color = sf::Color::White);
+    // Задать текстуру и область текстуры для зарегистрированного типа
+    void setTexture(TileId id, const sf::Texture& texture, const sf::IntRect& rect);
+    // Получить индекс типа по имени
+    TileId getId(const std::string& name) const;
+    // Получить имя типа по индексу
+    const std::string& getName(TileId id) const;
+    // Получить количество зарегистрированных типов
+    int getCount() const;
+    // Проверить, что тип зарегистрирован
+    bool isRegistered(int id) const;
+    // Проверить, что карта содержит только зарегистрированные типы
+    void validate(const TileGrid& tileMap) const;
+
+    // Получить данные отрисовки типа (без проверок, индекс покрывает весь диапазон TileId)
+    const TileType& operator[](TileId id) const { return m_types[id]; }
+
+private:
+    // Найти зарегистрированный тип или выбросить исключение
+    TileType& checkedType(TileId id);
+
+    std::array<TileType, MaxTileTypes> m_types; // Данные отрисовки по индексу
+    std::vector<std::string> m_names;           // Имена типов по индексу
+};
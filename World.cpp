@@ -0,0 +1,454 @@
+#include "World.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "CaveGenerator.h"
+#include "ChunkStore.h"
+#include "OreVeins.h"
+#include "Random.h"
+#include "ThreadPool.h"
+
+namespace
+{
+    const double NoiseScale = 0.01;           // Частота первой октавы шума на тайл
+    const int NoiseOctaves = 8;               // Количество октав
+    const double NoisePersistence = 0.5;      // Затухание октав
+    const std::uint32_t MaxOffsetX = 1 << 16; // Граница случайного смещения шума по горизонтали
+    const std::size_t ChunkOverhead = 64;     // Оценка памяти служебных данных чанка (узел таблицы, кольцо CLOCK)
+
+    // Получить координаты чанка по ключу World::chunkKey
+    void splitChunkKey(std::uint64_t key, int& chunkX, int& chunkY)
+    {
+        chunkX = static_cast<int>(static_cast<std::int32_t>(key >> 32));
+        chunkY = static_cast<int>(static_cast<std::int32_t>(key & 0xFFFFFFFFu));
+    }
+}
+
+// Создать мир высотой height тайлов с рудами resources (чанки не генерируются до первого обращения)
+World::World(std::uint64_t seed, int height, const std::vector<ResourceDefinition>& resources, ResourcePlacement placement)
+    : m_seed(seed)
+    , m_height(height)
+    , m_placement(placement)
+    , m_resources(resources, height)
+    , m_clockHand(0)
+    , m_memoryBudget(0)
+    , m_residentBytes(0)
+    , m_writeBackCount(0)
+{
+    if (height <= 0)
+    {
+        throw std::invalid_argument("Invalid world height");
+    }
+
+    // Зерно шума и смещения выводятся из зерна мира
+    RandomStream layoutRandom(deriveSeed(seed, WorldLayoutStream));
+    std::uint32_t noiseSeed = layoutRandom.nextUInt32() >> 1;
+    m_offsetX = static_cast<int>(layoutRandom.nextBelow(MaxOffsetX));
+    m_offsetY = static_cast<int>(layoutRandom.nextBelow(static_cast<std::uint32_t>(height)));
+    m_noise.reset(new NoiseEngine(noiseSeed));
+}
+
+// Записать изменённые чанки в хранилище
+World::~World()
+{
+    try
+    {
+        flush();
+    }
+    catch (...)
+    {
+        // Деструктор не должен бросать: изменения, которые не удалось записать, теряются
+    }
+}
+
+// Получить зерно мира
+std::uint64_t World::getSeed() const
+{
+    return m_seed;
+}
+
+// Получить высоту мира в тайлах
+int World::getHeight() const
+{
+    return m_height;
+}
+
+// Получить количество чанков по вертикали
+int World::getChunkCountY() const
+{
+    return (m_height + ChunkSize - 1) / ChunkSize;
+}
+
+// Получить количество чанков в памяти
+std::size_t World::getGeneratedChunkCount() const
+{
+    return m_chunks.size();
+}
+
+// Ограничить память под чанки (в байтах, 0 - без ограничения); лишние чанки вытесняются сразу
+void World::setMemoryBudget(std::size_t bytes)
+{
+    m_memoryBudget = bytes;
+    evictChunks(0);
+}
+
+// Получить бюджет памяти под чанки
+std::size_t World::getMemoryBudget() const
+{
+    return m_memoryBudget;
+}
+
+// Получить память, занятую чанками
+std::size_t World::getResidentBytes() const
+{
+    return m_residentBytes;
+}
+
+// Открыть хранилище изменённых чанков (без него изменённые чанки не вытесняются)
+void World::openChunkStore(const std::string& path)
+{
+    // Чанки другого мира легли бы в этот как попало: хранилище должно быть записано с тем же зерном и размерами
+    std::unique_ptr<ChunkStore> store(new ChunkStore(path, m_seed, m_height, ChunkSize));
+    if (store->getSeed() != m_seed || store->getWorldHeight() != m_height || store->getChunkSize() != ChunkSize)
+    {
+        throw std::runtime_error("Chunk store " + path + " belongs to another world (seed " + std::to_string(store->getSeed())
+            + ", height " + std::to_string(store->getWorldHeight()) + ", chunk size " + std::to_string(store->getChunkSize()) + ")");
+    }
+    m_store = std::move(store);
+
+    // Чанки в памяти могли быть сгенерированы до открытия хранилища: их сохранённые версии важнее
+    for (auto it = m_chunks.begin(); it != m_chunks.end(); ++it)
+    {
+        int chunkX, chunkY;
+        splitChunkKey(it->first, chunkX, chunkY);
+        if (!it->second.dirty && m_store->contains(chunkX, chunkY))
+        {
+            PackedChunk stored(*m_store->read(chunkX, chunkY));
+            m_residentBytes += chunkBytes(stored);
+            m_residentBytes -= chunkBytes(it->second.tiles);
+            it->second.tiles = std::move(stored);
+        }
+    }
+}
+
+// Записать все изменённые чанки в хранилище
+void World::flush()
+{
+    for (auto& chunk : m_chunks)
+    {
+        if (chunk.second.dirty)
+            writeBack(chunk.first, chunk.second);
+    }
+}
+
+// Получить количество чанков, записанных в хранилище при вытеснении и сбросе
+std::uint64_t World::getWriteBackCount() const
+{
+    return m_writeBackCount;
+}
+
+// Проверить, что чанк уже сгенерирован
+bool World::hasChunk(int chunkX, int chunkY) const
+{
+    return m_chunks.count(chunkKey(chunkX, chunkY)) != 0;
+}
+
+// Получить сгенерированный чанк или nullptr, если его ещё нет (без генерации)
+const PackedChunk* World::findChunk(int chunkX, int chunkY) const
+{
+    auto it = m_chunks.find(chunkKey(chunkX, chunkY));
+    return it != m_chunks.end() ? &it->second.tiles : nullptr;
+}
+
+// Получить тайл сгенерированного чанка; false, если чанка ещё нет (без генерации)
+bool World::findTile(int x, int y, TileId& tile) const
+{
+    int chunkX = floorDiv(x, ChunkSize);
+    int chunkY = floorDiv(y, ChunkSize);
+    const PackedChunk* chunk = findChunk(chunkX, chunkY);
+    if (!chunk)
+    {
+        return false;
+    }
+    tile = chunk->get(x - chunkX * ChunkSize, y - chunkY * ChunkSize);
+    return true;
+}
+
+// Получить чанк, сгенерировав его при первом обращении (у нижних чанков строк может быть меньше ChunkSize)
+const PackedChunk& World::getChunk(int chunkX, int chunkY)
+{
+    if (chunkY < 0 || chunkY >= getChunkCountY())
+    {
+        throw std::out_of_range("Chunk row out of range: " + std::to_string(chunkY));
+    }
+
+    ChunkEntry* entry = findEntry(chunkX, chunkY);
+    if (!entry)
+    {
+        entry = &storeChunk(chunkX, chunkY, loadChunk(chunkX, chunkY));
+    }
+    entry->referenced = true;
+    return entry->tiles;
+}
+
+// Получить тайл по координатам мира (y внутри высоты мира)
+TileId World::getTile(int x, int y)
+{
+    int chunkX = floorDiv(x, ChunkSize);
+    int chunkY = floorDiv(y, ChunkSize);
+    return getChunk(chunkX, chunkY).get(x - chunkX * ChunkSize, y - chunkY * ChunkSize);
+}
+
+// Изменить тайл по координатам мира (чанк помечается изменённым; если он вырос сверх бюджета, чанки вытесняются)
+void World::setTile(int x, int y, TileId tile)
+{
+    int chunkX = floorDiv(x, ChunkSize);
+    int chunkY = floorDiv(y, ChunkSize);
+    getChunk(chunkX, chunkY);
+    ChunkEntry* entry = findEntry(chunkX, chunkY);
+    std::size_t oldBytes = chunkBytes(entry->tiles);
+    entry->tiles.set(x - chunkX * ChunkSize, y - chunkY * ChunkSize, tile);
+    std::size_t newBytes = chunkBytes(entry->tiles);
+    m_residentBytes -= oldBytes;
+    m_residentBytes += newBytes;
+    entry->dirty = true;
+
+    // Новый тайл мог расширить палитру и разрядность чанка: память сверх бюджета освобождается сразу
+    if (newBytes > oldBytes)
+        evictChunks(0);
+}
+
+// Отметить обращение к чанку в памяти, чтобы он не был вытеснен первым
+void World::touchChunk(int chunkX, int chunkY)
+{
+    ChunkEntry* entry = findEntry(chunkX, chunkY);
+    if (entry)
+        entry->referenced = true;
+}
+
+// Сгенерировать недостающие чанки, пересекающие прямоугольник (в тайлах), на пуле потоков или здесь же
+void World::generateChunks(const sf::IntRect& tiles, ThreadPool* pool)
+{
+    if (tiles.width <= 0 || tiles.height <= 0)
+    {
+        return;
+    }
+
+    int firstX = floorDiv(tiles.left, ChunkSize);
+    int lastX = floorDiv(tiles.left + tiles.width - 1, ChunkSize);
+    int firstY = std::max(0, floorDiv(tiles.top, ChunkSize));
+    int lastY = std::min(getChunkCountY() - 1, floorDiv(tiles.top + tiles.height - 1, ChunkSize));
+
+    std::vector<sf::Vector2i> missing;
+    for (int chunkY = firstY; chunkY <= lastY; ++chunkY)
+    {
+        for (int chunkX = firstX; chunkX <= lastX; ++chunkX)
+        {
+            if (!hasChunk(chunkX, chunkY))
+                missing.push_back(sf::Vector2i(chunkX, chunkY));
+        }
+    }
+
+    // Чанки генерируются (или читаются) и упаковываются независимо, в таблицу они попадают уже в этом потоке
+    std::vector<PackedChunk> generated(missing.size());
+    auto generateRange = [&](int begin, int end)
+    {
+        for (int i = begin; i < end; ++i)
+        {
+            generated[i] = loadChunk(missing[i].x, missing[i].y);
+        }
+    };
+    if (pool)
+        pool->parallelFor(static_cast<int>(missing.size()), 1, generateRange);
+    else
+        generateRange(0, static_cast<int>(missing.size()));
+
+    for (std::size_t i = 0; i < missing.size(); ++i)
+    {
+        storeChunk(missing[i].x, missing[i].y, std::move(generated[i]));
+    }
+}
+
+// Скопировать прямоугольник мира (в тайлах) в отдельную карту
+TileGrid World::copyRegion(const sf::IntRect& tiles, ThreadPool* pool)
+{
+    if (tiles.top < 0 || tiles.height < 0 || tiles.width < 0 || tiles.top + tiles.height > m_height)
+    {
+        throw std::out_of_range("Region is outside the world height");
+    }
+
+    // Полоса чанков за раз: при малом бюджете памяти прямоугольник целиком может не поместиться
+    TileGrid region(tiles.width, tiles.height);
+    if (tiles.width == 0 || tiles.height == 0)
+    {
+        return region;
+    }
+    int firstY = tiles.top / ChunkSize;
+    int lastY = (tiles.top + tiles.height - 1) / ChunkSize;
+    for (int chunkY = firstY; chunkY <= lastY; ++chunkY)
+    {
+        int top = std::max(tiles.top, chunkY * ChunkSize);
+        int bottom = std::min(tiles.top + tiles.height, (chunkY + 1) * ChunkSize);
+        generateChunks(sf::IntRect(tiles.left, top, tiles.width, bottom - top), pool);
+
+        for (int x = 0; x < tiles.width;)
+        {
+            // Скопировать часть чанка, попадающую в прямоугольник
+            int worldX = tiles.left + x;
+            int chunkX = floorDiv(worldX, ChunkSize);
+            int localX = worldX - chunkX * ChunkSize;
+            int count = std::min(ChunkSize - localX, tiles.width - x);
+            const PackedChunk& chunk = getChunk(chunkX, chunkY);
+            for (int worldY = top; worldY < bottom; ++worldY)
+            {
+                TileId source[ChunkSize];
+                chunk.decodeRow(worldY - chunkY * ChunkSize, source);
+                std::copy(source + localX, source + localX + count, region.row(worldY - tiles.top).data() + x);
+            }
+            x += count;
+        }
+    }
+    return region;
+}
+
+// Добавить сгенерированный в другом месте чанк (если чанк уже есть, он заменяется)
+void World::insertChunk(int chunkX, int chunkY, PackedChunk tiles)
+{
+    storeChunk(chunkX, chunkY, std::move(tiles));
+}
+
+// Сгенерировать чанк, не добавляя его в мир (не меняет мир, можно вызывать из нескольких потоков)
+std::unique_ptr<TileGrid> World::generateChunk(int chunkX, int chunkY) const
+{
+    int originX = chunkX * ChunkSize;
+    int originY = chunkY * ChunkSize;
+    std::unique_ptr<TileGrid> chunk(new TileGrid(ChunkSize, std::min(ChunkSize, m_height - originY)));
+
+    // Высоты столбцов считаются по координатам мира, поэтому соседние чанки стыкуются;
+    // пещерам нужны и высоты CaveMargin столбцов по сторонам чанка
+    std::vector<int> surface = generateHeightMap(*m_noise, ChunkSize + 2 * CaveMargin, m_height, NoiseScale, NoiseOctaves, NoisePersistence,
+        static_cast<std::int64_t>(m_offsetX) + static_cast<std::int64_t>(chunkX) * ChunkSize - CaveMargin, m_offsetY);
+    std::vector<int> heightMap(surface.begin() + CaveMargin, surface.begin() + CaveMargin + ChunkSize);
+    generateTerrain(*chunk, originY, heightMap);
+    generateCaves(*chunk, originX, originY, m_height, surface, originX - CaveMargin, m_seed);
+
+    if (m_placement == ResourcePlacement::Veins)
+    {
+        generateOreVeins(*chunk, originX, originY, m_resources, m_seed);
+        return chunk;
+    }
+    RandomStream random(deriveSeed(deriveSeed(deriveSeed(m_seed, ChunkResourceStream),
+        static_cast<std::uint64_t>(static_cast<std::int64_t>(chunkX))), static_cast<std::uint64_t>(chunkY)));
+    generateUndergroundResources(*chunk, originY, m_resources, random, m_placement);
+    return chunk;
+}
+
+// Прочитать чанк из хранилища или сгенерировать и упаковать, не добавляя его в мир (можно вызывать из нескольких потоков)
+PackedChunk World::loadChunk(int chunkX, int chunkY) const
+{
+    if (m_store)
+    {
+        std::unique_ptr<TileGrid> stored = m_store->read(chunkX, chunkY);
+        if (stored)
+            return PackedChunk(*stored);
+    }
+    return PackedChunk(*generateChunk(chunkX, chunkY));
+}
+
+// Получить чанк в памяти или nullptr
+World::ChunkEntry* World::findEntry(int chunkX, int chunkY)
+{
+    auto it = m_chunks.find(chunkKey(chunkX, chunkY));
+    return it != m_chunks.end() ? &it->second : nullptr;
+}
+
+// Добавить чанк в память, сначала освободив место под него
+World::ChunkEntry& World::storeChunk(int chunkX, int chunkY, PackedChunk tiles)
+{
+    std::uint64_t key = chunkKey(chunkX, chunkY);
+    auto it = m_chunks.find(key);
+    if (it != m_chunks.end())
+    {
+        // Замена чанка: изменённая версия в памяти новее пришедшей
+        ChunkEntry& entry = it->second;
+        if (!entry.dirty)
+        {
+            m_residentBytes += chunkBytes(tiles);
+            m_residentBytes -= chunkBytes(entry.tiles);
+            entry.tiles = std::move(tiles);
+        }
+        entry.referenced = true;
+        return entry;
+    }
+
+    // Вытеснение до вставки: новый чанк не может оказаться своей же жертвой
+    std::size_t bytes = chunkBytes(tiles);
+    evictChunks(bytes);
+
+    ChunkEntry& entry = m_chunks[key];
+    entry.tiles = std::move(tiles);
+    m_clock.push_back(key);
+    m_residentBytes += bytes;
+    return entry;
+}
+
+// Вытеснять чанки, пока занятая память с учётом extraBytes превышает бюджет
+void World::evictChunks(std::size_t extraBytes)
+{
+    if (m_memoryBudget == 0)
+    {
+        return;
+    }
+
+    // Стрелка идёт по кольцу: чанк с битом обращения получает второй шанс (бит сбрасывается),
+    // чанк без него вытесняется. Изменённый чанк без хранилища некуда записать, и он остаётся в памяти:
+    // если за два оборота жертвы не нашлось, в памяти только такие чанки, и бюджет превышается
+    std::size_t skipped = 0; // Чанков, пропущенных стрелкой с последнего вытеснения
+    while (!m_clock.empty() && m_residentBytes + extraBytes > m_memoryBudget && skipped < 2 * m_clock.size())
+    {
+        if (m_clockHand >= m_clock.size())
+            m_clockHand = 0;
+
+        std::uint64_t key = m_clock[m_clockHand];
+        ChunkEntry& entry = m_chunks[key];
+        if (entry.referenced || (entry.dirty && !m_store))
+        {
+            entry.referenced = false;
+            ++m_clockHand;
+            ++skipped;
+            continue;
+        }
+
+        if (entry.dirty)
+            writeBack(key, entry);
+        m_residentBytes -= chunkBytes(entry.tiles);
+        m_chunks.erase(key);
+
+        // Место жертвы в кольце занимает последний ключ, стрелка остаётся на месте
+        m_clock[m_clockHand] = m_clock.back();
+        m_clock.pop_back();
+        skipped = 0;
+    }
+}
+
+// Записать изменённый чанк в хранилище
+void World::writeBack(std::uint64_t key, ChunkEntry& entry)
+{
+    if (!m_store)
+    {
+        return;
+    }
+    int chunkX, chunkY;
+    splitChunkKey(key, chunkX, chunkY);
+    m_store->write(chunkX, chunkY, entry.tiles.unpack());
+    entry.dirty = false;
+    ++m_writeBackCount;
+}
+
+// Получить память, которую занимает чанк
+std::size_t World::chunkBytes(const PackedChunk& tiles)
+{
+    return sizeof(ChunkEntry) + tiles.getDataBytes() + ChunkOverhead;
+}
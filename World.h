@@ -0,0 +1,136 @@
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "NoiseEngine.h"
+#include "PackedChunk.h"
+#include "TerrainGenerator.h"
+#include "TileGrid.h"
+
+class ChunkStore;
+class ThreadPool;
+
+// Целочисленное деление с округлением вниз (для отрицательных координат)
+inline int floorDiv(int value, int divisor)
+{
+    int quotient = value / divisor;
+    return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? quotient - 1 : quotient;
+}
+
+// Мир из чанков ChunkSize x ChunkSize тайлов, неограниченный по горизонтали.
+// Чанк генерируется при первом обращении (шум, рельеф, пещеры, руды) и зависит только от зерна
+// мира и координат чанка, поэтому порядок обращений не влияет на результат.
+// Память под чанки ограничивается бюджетом: при его превышении чанки вытесняются
+// алгоритмом CLOCK; нетронутые просто выбрасываются (их можно сгенерировать снова),
+// изменённые записываются в хранилище чанков и читаются из него при следующем обращении
+// (пока хранилище не открыто, изменённые чанки остаются в памяти, даже сверх бюджета).
+// В памяти чанки хранятся сжатыми палитрой (PackedChunk)
+class World
+{
+public:
+    static constexpr int ChunkSize = 32; // Размер чанка в тайлах
+
+    // Создать мир высотой height тайлов с рудами resources (чанки не генерируются до первого обращения)
+    World(std::uint64_t seed, int height, const std::vector<ResourceDefinition>& resources, ResourcePlacement placement = ResourcePlacement::SkipSampling);
+    // Записать изменённые чанки в хранилище
+    ~World();
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    // Получить зерно мира
+    std::uint64_t getSeed() const;
+    // Получить высоту мира в тайлах
+    int getHeight() const;
+    // Получить количество чанков по вертикали
+    int getChunkCountY() const;
+    // Получить количество чанков в памяти
+    std::size_t getGeneratedChunkCount() const;
+
+    // Ограничить память под чанки (в байтах, 0 - без ограничения); лишние чанки вытесняются сразу
+    // (изменённые - только при открытом хранилище)
+    void setMemoryBudget(std::size_t bytes);
+    // Получить бюджет памяти под чанки
+    std::size_t getMemoryBudget() const;
+    // Получить память, занятую чанками
+    std::size_t getResidentBytes() const;
+    // Открыть хранилище изменённых чанков (без него изменённые чанки не вытесняются).
+    // Исключение, если хранилище записано для мира с другими зерном, высотой или размером чанка
+    void openChunkStore(const std::string& path);
+    // Записать все изменённые чанки в хранилище
+    void flush();
+    // Получить количество чанков, записанных в хранилище при вытеснении и сбросе
+    std::uint64_t getWriteBackCount() const;
+
+    // Проверить, что чанк уже сгенерирован
+    bool hasChunk(int chunkX, int chunkY) const;
+    // Получить сгенерированный чанк или nullptr, если его ещё нет (без генерации)
+    const PackedChunk* findChunk(int chunkX, int chunkY) const;
+    // Получить тайл сгенерированного чанка; false, если чанка ещё нет (без генерации)
+    bool findTile(int x, int y, TileId& tile) const;
+    // Получить чанк, сгенерировав его при первом обращении (у нижних чанков строк может быть меньше ChunkSize)
+    const PackedChunk& getChunk(int chunkX, int chunkY);
+    // Получить тайл по координатам мира (y внутри высоты мира)
+    TileId getTile(int x, int y);
+    // Изменить тайл по координатам мира (чанк помечается изменённым; если он вырос сверх бюджета, чанки вытесняются)
+    void setTile(int x, int y, TileId tile);
+    // Отметить обращение к чанку в памяти, чтобы он не был вытеснен первым
+    void touchChunk(int chunkX, int chunkY);
+    // Сгенерировать недостающие чанки, пересекающие прямоугольник (в тайлах), на пуле потоков или здесь же
+    void generateChunks(const sf::IntRect& tiles, ThreadPool* pool = nullptr);
+    // Скопировать прямоугольник мира (в тайлах) в отдельную карту
+    TileGrid copyRegion(const sf::IntRect& tiles, ThreadPool* pool = nullptr);
+
+    // Сгенерировать чанк, не добавляя его в мир (не меняет мир, можно вызывать из нескольких потоков)
+    std::unique_ptr<TileGrid> generateChunk(int chunkX, int chunkY) const;
+    // Прочитать чанк из хранилища или сгенерировать и упаковать, не добавляя его в мир (можно вызывать из нескольких потоков)
+    PackedChunk loadChunk(int chunkX, int chunkY) const;
+    // Добавить сгенерированный в другом месте чанк (если чанк уже есть, он заменяется)
+    void insertChunk(int chunkX, int chunkY, PackedChunk tiles);
+
+    // Получить ключ чанка для хеш-таблиц
+    static std::uint64_t chunkKey(int chunkX, int chunkY)
+    {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(chunkX)) << 32) | static_cast<std::uint32_t>(chunkY);
+    }
+
+private:
+    // Чанк в памяти
+    struct ChunkEntry
+    {
+        PackedChunk tiles;               // Тайлы чанка
+        bool referenced = true;          // Было обращение с последнего прохода стрелки CLOCK
+        bool dirty = false;              // Чанк изменён и не записан в хранилище
+    };
+
+    // Получить чанк в памяти или nullptr
+    ChunkEntry* findEntry(int chunkX, int chunkY);
+    // Добавить чанк в память, сначала освободив место под него
+    ChunkEntry& storeChunk(int chunkX, int chunkY, PackedChunk tiles);
+    // Вытеснять чанки, пока занятая память с учётом extraBytes превышает бюджет
+    void evictChunks(std::size_t extraBytes);
+    // Записать изменённый чанк в хранилище
+    void writeBack(std::uint64_t key, ChunkEntry& entry);
+    // Получить память, которую занимает чанк
+    static std::size_t chunkBytes(const PackedChunk& tiles);
+
+    std::uint64_t m_seed;                                                  // Зерно мира
+    int m_height;                                                          // Высота мира в тайлах
+    ResourcePlacement m_placement;                                         // Способ размещения руд
+    ResourceTables m_resources;                                            // Таблицы руд, скомпилированные для высоты мира
+    std::unique_ptr<NoiseEngine> m_noise;                                  // Шум карты высот
+    int m_offsetX;                                                         // Смещение шума по горизонтали
+    int m_offsetY;                                                         // Смещение шума по вертикали
+    std::unordered_map<std::uint64_t, ChunkEntry> m_chunks;                // Чанки в памяти по ключу
+    std::vector<std::uint64_t> m_clock;                                    // Кольцо ключей чанков для CLOCK
+    std::size_t m_clockHand;                                               // Стрелка CLOCK (индекс в m_clock)
+    std::size_t m_memoryBudget;                                            // Бюджет памяти под чанки (0 - без ограничения)
+    std::size_t m_residentBytes;                                           // Память, занятая чанками
+    std::unique_ptr<ChunkStore> m_store;                                   // Хранилище изменённых чанков
+    std::uint64_t m_writeBackCount;                                        // Количество записанных чанков
+};
@@ -0,0 +1,277 @@
+#include "WorldFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+    static_assert(sizeof(WorldFileHeader) == 32, "World file header must have no padding");
+    static_assert(sizeof(WorldChunkEntry) == 16, "World chunk entry must have no padding");
+
+    const std::size_t TableAlignment = 8; // Выравнивание таблицы чанков в файле
+
+    // Округлить размер вверх до кратного TableAlignment
+    std::size_t alignTable(std::size_t size)
+    {
+        return (size + TableAlignment - 1) / TableAlignment * TableAlignment;
+    }
+}
+
+// Записать карту в двоичный файл мира (имена типов берутся из реестра)
+void saveWorldFile(const std::string& path, const TileGrid& tileMap, std::uint64_t seed, const TileRegistry& tileRegistry, int chunkSize)
+{
+    if (chunkSize <= 0)
+    {
+        throw std::invalid_argument("Invalid world chunk size");
+    }
+    tileRegistry.validate(tileMap);
+
+    WorldFileHeader header = {};
+    std::memcpy(header.magic, WorldFileFormat::Magic, sizeof(header.magic));
+    header.version = WorldFileFormat::Version;
+    header.seed = seed;
+    header.width = tileMap.getWidth();
+    header.height = tileMap.getHeight();
+    header.chunkSize = chunkSize;
+    header.paletteSize = static_cast<std::uint32_t>(tileRegistry.getCount());
+
+    // Палитра совпадает с реестром: индекс в файле равен индексу типа
+    std::vector<char> palette;
+    for (int id = 0; id < tileRegistry.getCount(); ++id)
+    {
+        const std::string& name = tileRegistry.getName(static_cast<TileId>(id));
+        if (name.size() > 255)
+        {
+            throw std::length_error("Tile type name is too long: " + name);
+        }
+        palette.push_back(static_cast<char>(name.size()));
+        palette.insert(palette.end(), name.begin(), name.end());
+    }
+    palette.resize(alignTable(sizeof(header) + palette.size()) - sizeof(header), 0);
+
+    // Данные чанков идут сразу за таблицей в порядке таблицы
+    const int chunkCountX = (header.width + chunkSize - 1) / chunkSize;
+    const int chunkCountY = (header.height + chunkSize - 1) / chunkSize;
+    std::vector<WorldChunkEntry> chunks(static_cast<std::size_t>(chunkCountX) * chunkCountY);
+    std::uint64_t offset = sizeof(header) + palette.size() + chunks.size() * sizeof(WorldChunkEntry);
+    for (int chunkY = 0; chunkY < chunkCountY; ++chunkY)
+    {
+        for (int chunkX = 0; chunkX < chunkCountX; ++chunkX)
+        {
+            int chunkWidth = std::min(chunkSize, header.width - chunkX * chunkSize);
+            int chunkHeight = std::min(chunkSize, header.height - chunkY * chunkSize);
+            WorldChunkEntry& entry = chunks[static_cast<std::size_t>(chunkY) * chunkCountX + chunkX];
+            entry.offset = offset;
+            entry.size = static_cast<std::uint32_t>(chunkWidth * chunkHeight);
+            entry.encoding = WorldFileFormat::RawChunk;
+            offset += entry.size;
+        }
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open file for writing: " + path);
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(palette.data(), palette.size());
+    file.write(reinterpret_cast<const char*>(chunks.data()), chunks.size() * sizeof(WorldChunkEntry));
+
+    // Чанки одной строки чанков собираются в буфер и пишутся одним блоком
+    std::vector<char> buffer;
+    for (int chunkY = 0; chunkY < chunkCountY; ++chunkY)
+    {
+        buffer.clear();
+        int firstY = chunkY * chunkSize;
+        int lastY = std::min(firstY + chunkSize, header.height);
+        for (int chunkX = 0; chunkX < chunkCountX; ++chunkX)
+        {
+            int firstX = chunkX * chunkSize;
+            int lastX = std::min(firstX + chunkSize, header.width);
+            for (int y = firstY; y < lastY; ++y)
+            {
+                TileSpan<const TileId> row = tileMap.row(y);
+                buffer.insert(buffer.end(), row.data() + firstX, row.data() + lastX);
+            }
+        }
+        file.write(buffer.data(), buffer.size());
+    }
+    file.close();
+
+    if (!file)
+    {
+        throw std::runtime_error("Failed to write file: " + path);
+    }
+}
+
+// Открыть файл, проверить заголовок и таблицу чанков, сопоставить палитру с реестром
+WorldFile::WorldFile(const std::string& path, const TileRegistry& tileRegistry)
+    : m_file(new MappedFile(path))
+    , m_chunkCountX(0)
+    , m_chunkCountY(0)
+    , m_chunks(nullptr)
+{
+    const char* data = m_file->data();
+    const std::size_t size = m_file->size();
+
+    if (size < sizeof(m_header))
+    {
+        throw std::runtime_error("Not a world file: " + path);
+    }
+    std::memcpy(&m_header, data, sizeof(m_header));
+    if (std::memcmp(m_header.magic, WorldFileFormat::Magic, sizeof(m_header.magic)) != 0)
+    {
+        throw std::runtime_error("Not a world file: " + path);
+    }
+    if (m_header.version != WorldFileFormat::Version)
+    {
+        throw std::runtime_error("Unsupported world file version: " + std::to_string(m_header.version));
+    }
+    if (m_header.width <= 0 || m_header.height <= 0 || m_header.chunkSize <= 0 || m_header.paletteSize > 256)
+    {
+        throw std::runtime_error("Corrupt world file header: " + path);
+    }
+
+    // Сопоставить имена палитры с типами реестра
+    std::size_t position = sizeof(m_header);
+    m_paletteToId.fill(0);
+    for (std::uint32_t i = 0; i < m_header.paletteSize; ++i)
+    {
+        if (position >= size || position + 1 + static_cast<unsigned char>(data[position]) > size)
+        {
+            throw std::runtime_error("Corrupt world file palette: " + path);
+        }
+        std::size_t length = static_cast<unsigned char>(data[position]);
+        m_paletteToId[i] = tileRegistry.getId(std::string(data + position + 1, length));
+        position += 1 + length;
+    }
+    position = alignTable(position);
+
+    // Таблица чанков используется прямо из отображения
+    m_chunkCountX = (m_header.width + m_header.chunkSize - 1) / m_header.chunkSize;
+    m_chunkCountY = (m_header.height + m_header.chunkSize - 1) / m_header.chunkSize;
+    std::size_t chunkCount = static_cast<std::size_t>(m_chunkCountX) * m_chunkCountY;
+    if (position > size || (size - position) / sizeof(WorldChunkEntry) < chunkCount)
+    {
+        throw std::runtime_error("Corrupt world file chunk table: " + path);
+    }
+    m_chunks = reinterpret_cast<const WorldChunkEntry*>(data + position);
+
+    for (int chunkY = 0; chunkY < m_chunkCountY; ++chunkY)
+    {
+        for (int chunkX = 0; chunkX < m_chunkCountX; ++chunkX)
+        {
+            const WorldChunkEntry& entry = m_chunks[static_cast<std::size_t>(chunkY) * m_chunkCountX + chunkX];
+            sf::IntRect rect = getChunkRect(chunkX, chunkY);
+            if (entry.encoding != WorldFileFormat::RawChunk
+                || entry.size != static_cast<std::uint32_t>(rect.width * rect.height)
+                || entry.offset > size || size - entry.offset < entry.size)
+            {
+                throw std::runtime_error("Corrupt world file chunk: " + path);
+            }
+        }
+    }
+
+    m_loaded.assign(chunkCount, false);
+}
+
+// Получить зерно мира
+std::uint64_t WorldFile::getSeed() const
+{
+    return m_header.seed;
+}
+
+// Получить ширину карты в тайлах
+int WorldFile::getWidth() const
+{
+    return m_header.width;
+}
+
+// Получить высоту карты в тайлах
+int WorldFile::getHeight() const
+{
+    return m_header.height;
+}
+
+// Получить размер чанка в тайлах
+int WorldFile::getChunkSize() const
+{
+    return m_header.chunkSize;
+}
+
+// Скопировать тайлы чанка в карту того же размера, что и мир
+void WorldFile::readChunk(int chunkX, int chunkY, TileGrid& tileMap) const
+{
+    if (tileMap.getWidth() != m_header.width || tileMap.getHeight() != m_header.height)
+    {
+        throw std::invalid_argument("Tile map size does not match the world file");
+    }
+
+    const WorldChunkEntry& entry = m_chunks[static_cast<std::size_t>(chunkY) * m_chunkCountX + chunkX];
+    const unsigned char* source = reinterpret_cast<const unsigned char*>(m_file->data() + entry.offset);
+    sf::IntRect rect = getChunkRect(chunkX, chunkY);
+
+    for (int y = rect.top; y < rect.top + rect.height; ++y)
+    {
+        TileSpan<TileId> row = tileMap.row(y);
+        for (int x = rect.left; x < rect.left + rect.width; ++x)
+        {
+            unsigned char value = *source++;
+            if (value >= m_header.paletteSize)
+            {
+                throw std::runtime_error("Corrupt world file: tile outside the palette");
+            }
+            row[x] = m_paletteToId[value];
+        }
+    }
+}
+
+// Скопировать ещё не прочитанные чанки, пересекающие прямоугольник (в тайлах);
+// вернуть прямоугольники прочитанных чанков
+std::vector<sf::IntRect> WorldFile::loadChunks(const sf::IntRect& tiles, TileGrid& tileMap)
+{
+    std::vector<sf::IntRect> loaded;
+    if (tiles.width <= 0 || tiles.height <= 0)
+    {
+        return loaded;
+    }
+
+    const int chunkSize = m_header.chunkSize;
+    int firstX = std::max(0, tiles.left / chunkSize);
+    int firstY = std::max(0, tiles.top / chunkSize);
+    int lastX = std::min(m_chunkCountX - 1, (tiles.left + tiles.width - 1) / chunkSize);
+    int lastY = std::min(m_chunkCountY - 1, (tiles.top + tiles.height - 1) / chunkSize);
+
+    for (int chunkY = firstY; chunkY <= lastY; ++chunkY)
+    {
+        for (int chunkX = firstX; chunkX <= lastX; ++chunkX)
+        {
+            std::size_t index = static_cast<std::size_t>(chunkY) * m_chunkCountX + chunkX;
+            if (m_loaded[index])
+                continue;
+
+            readChunk(chunkX, chunkY, tileMap);
+            m_loaded[index] = true;
+            loaded.push_back(getChunkRect(chunkX, chunkY));
+        }
+    }
+    return loaded;
+}
+
+// Скопировать все чанки
+void WorldFile::loadAll(TileGrid& tileMap)
+{
+    loadChunks(sf::IntRect(0, 0, m_header.width, m_header.height), tileMap);
+}
+
+// Получить прямоугольник чанка в тайлах
+sf::IntRect WorldFile::getChunkRect(int chunkX, int chunkY) const
+{
+    int left = chunkX * m_header.chunkSize;
+    int top = chunkY * m_header.chunkSize;
+    return sf::IntRect(left, top,
+        std::min(m_header.chunkSize, m_header.width - left),
+        std::min(m_header.chunkSize, m_header.height - top));
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+#include "TileGrid.h"
+#include "TileRegistry.h"
+
+// Двоичный файл мира:
+//   заголовок WorldFileHeader;
+//   палитра: имена типов тайлов для индексов 0..paletteSize-1 (байт длины и символы), выровнена до 8 байт;
+//   таблица чанков WorldChunkEntry построчно (chunkCountX * chunkCountY записей);
+//   данные чанков: индексы тайлов по палитре, построчно (у крайних чанков строки короче).
+// Числа записываются в порядке байтов little-endian
+namespace WorldFileFormat
+{
+    const char Magic[4] = { 'T', 'W', 'L', 'D' }; // Сигнатура файла
+    const std::uint32_t Version = 1;              // Версия формата
+    const int DefaultChunkSize = 32;              // Размер чанка в тайлах по умолчанию
+
+    // Способ хранения данных чанка
+    enum ChunkEncoding : std::uint32_t
+    {
+        RawChunk = 0 // Один байт на тайл
+    };
+}
+
+// Заголовок файла мира
+struct WorldFileHeader
+{
+    char magic[4];             // Сигнатура WorldFileFormat::Magic
+    std::uint32_t version;     // Версия формата
+    std::uint64_t seed;        // Зерно мира
+    std::int32_t width;        // Ширина карты в тайлах
+    std::int32_t height;       // Высота карты в тайлах
+    std::int32_t chunkSize;    // Размер чанка в тайлах
+    std::uint32_t paletteSize; // Количество типов тайлов в палитре
+};
+
+// Запись таблицы чанков
+struct WorldChunkEntry
+{
+    std::uint64_t offset;   // Смещение данных чанка от начала файла
+    std::uint32_t size;     // Размер данных чанка в байтах
+    std::uint32_t encoding; // Способ хранения WorldFileFormat::ChunkEncoding
+};
+
+// Записать карту в двоичный файл мира (имена типов берутся из реестра)
+void saveWorldFile(const std::string& path, const TileGrid& tileMap, std::uint64_t seed, const TileRegistry& tileRegistry,
+    int chunkSize = WorldFileFormat::DefaultChunkSize);
+
+// Открытый файл мира: файл отображается в память, чанки читаются по запросу
+class WorldFile
+{
+public:
+    // Открыть файл, проверить заголовок и таблицу чанков, сопоставить палитру с реестром
+    WorldFile(const std::string& path, const TileRegistry& tileRegistry);
+
+    // Получить зерно мира
+    std::uint64_t getSeed() const;
+    // Получить ширину карты в тайлах
+    int getWidth() const;
+    // Получить высоту карты в тайлах
+    int getHeight() const;
+    // Получить размер чанка в тайлах
+    int getChunkSize() const;
+
+    // Скопировать тайлы чанка в карту того же размера, что и мир
+    void readChunk(int chunkX, int chunkY, TileGrid& tileMap) const;
+    // Скопировать ещё не прочитанные чанки, пересекающие прямоугольник (в тайлах);
+    // вернуть прямоугольники прочитанных чанков
+    std::vector<sf::IntRect> loadChunks(const sf::IntRect& tiles, TileGrid& tileMap);
+    // Скопировать все чанки
+    void loadAll(TileGrid& tileMap);
+
+private:
+    // Получить прямоугольник чанка в тайлах
+    sf::IntRect getChunkRect(int chunkX, int chunkY) const;
+
+    std::unique_ptr<MappedFile> m_file;    // Отображение файла
+    WorldFileHeader m_header;              // Заголовок
+    int m_chunkCountX;                     // Количество чанков по горизонтали
+    int m_chunkCountY;                     // Количество чанков по вертикали
+    const WorldChunkEntry* m_chunks;       // Таблица чанков внутри отображения
+    std::array<TileId, 256> m_paletteToId; // Индекс в реестре по индексу палитры
+    std::vector<bool> m_loaded;            // Чанки, уже скопированные в карту
+};
@@ -0,0 +1,130 @@
+#include "ZLevelMap.h"
+
+#include <stdexcept>
+#include <string>
+
+#include "World.h"
+
+// Создать карту width x height тайлов из levelCount уровней, заполненных тайлом fill
+ZLevelMap::ZLevelMap(int width, int height, int levelCount, TileId fill)
+    : m_width(width)
+    , m_height(height)
+{
+    if (width <= 0 || height <= 0 || levelCount <= 0)
+    {
+        throw std::invalid_argument("Invalid z-level map size");
+    }
+    m_levels.resize(levelCount);
+    for (auto& level : m_levels)
+    {
+        level.fill = fill;
+    }
+}
+
+// Получить заполнитель уровня (тайл всех невыделенных чанков)
+TileId ZLevelMap::getLevelFill(int z) const
+{
+    return m_levels.at(z).fill;
+}
+
+// Заменить заполнитель уровня (меняет все тайлы уровня вне выделенных чанков)
+void ZLevelMap::setLevelFill(int z, TileId fill)
+{
+    m_levels.at(z).fill = fill;
+}
+
+// Получить тайл (исключение, если координаты вне карты)
+TileId ZLevelMap::getTile(int x, int y, int z) const
+{
+    check(x, y, z);
+    const Level& level = m_levels[z];
+    int chunkX = x / ChunkSize;
+    int chunkY = y / ChunkSize;
+    auto it = level.chunks.find(World::chunkKey(chunkX, chunkY));
+    if (it == level.chunks.end())
+    {
+        return level.fill;
+    }
+    return it->second.get(x - chunkX * ChunkSize, y - chunkY * ChunkSize);
+}
+
+// Изменить тайл (исключение, если координаты вне карты); чанк выделяется при первом отличии от заполнителя
+void ZLevelMap::setTile(int x, int y, int z, TileId tile)
+{
+    check(x, y, z);
+    Level& level = m_levels[z];
+    int chunkX = x / ChunkSize;
+    int chunkY = y / ChunkSize;
+    std::uint64_t key = World::chunkKey(chunkX, chunkY);
+    auto it = level.chunks.find(key);
+    if (it == level.chunks.end())
+    {
+        if (tile == level.fill)
+            return;
+        it = level.chunks.emplace(key, PackedChunk(getChunkWidth(chunkX), getChunkHeight(chunkY), level.fill)).first;
+    }
+    it->second.set(x - chunkX * ChunkSize, y - chunkY * ChunkSize, tile);
+}
+
+// Получить выделенный чанк уровня или nullptr, если весь чанк - заполнитель уровня
+const PackedChunk* ZLevelMap::findChunk(int chunkX, int chunkY, int z) const
+{
+    const Level& level = m_levels.at(z);
+    auto it = level.chunks.find(World::chunkKey(chunkX, chunkY));
+    return it != level.chunks.end() ? &it->second : nullptr;
+}
+
+// Переупаковать чанки (палитры без исчезнувших типов) и освободить чанки, ставшие заполнителем уровня
+void ZLevelMap::compact()
+{
+    for (auto& level : m_levels)
+    {
+        for (auto it = level.chunks.begin(); it != level.chunks.end();)
+        {
+            PackedChunk repacked(it->second.unpack());
+            if (repacked.getBitsPerTile() == 0 && repacked.getPalette()[0] == level.fill)
+            {
+                it = level.chunks.erase(it);
+                continue;
+            }
+            it->second = std::move(repacked);
+            ++it;
+        }
+    }
+}
+
+// Получить количество выделенных чанков на всех уровнях
+std::size_t ZLevelMap::getAllocatedChunkCount() const
+{
+    std::size_t count = 0;
+    for (const auto& level : m_levels)
+    {
+        count += level.chunks.size();
+    }
+    return count;
+}
+
+// Получить память, занятую уровнями и чанками
+std::size_t ZLevelMap::getMemoryBytes() const
+{
+    // Узел хеш-таблицы оценивается как ключ, чанк и два указателя
+    std::size_t bytes = sizeof(*this) + m_levels.capacity() * sizeof(Level);
+    for (const auto& level : m_levels)
+    {
+        bytes += level.chunks.bucket_count() * sizeof(void*);
+        for (const auto& chunk : level.chunks)
+        {
+            bytes += sizeof(chunk) + 2 * sizeof(void*) + chunk.second.getDataBytes();
+        }
+    }
+    return bytes;
+}
+
+// Проверить координаты и бросить исключение, если они вне карты
+void ZLevelMap::check(int x, int y, int z) const
+{
+    if (!contains(x, y, z))
+    {
+        throw std::out_of_range("Tile out of range: " + std::to_string(x) + ", " + std::to_string(y) + ", " + std::to_string(z));
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "PackedChunk.h"
+#include "TileGrid.h"
+
+// Трёхмерная карта (x, y, z) из горизонтальных z-уровней, как в Dwarf Fortress.
+// Каждый уровень хранит только чанки, отличающиеся от его заполнителя (воздух выше
+// поверхности, камень ниже), в том же сжатом палитрой виде, что и чанки мира (PackedChunk).
+// Поэтому уровень из одного воздуха или сплошного камня почти ничего не стоит,
+// и сотни уровней занимают память пропорционально числу изменённых чанков
+class ZLevelMap
+{
+public:
+    static const int ChunkSize = 32; // Размер чанка уровня в тайлах (совпадает с чанком мира)
+
+    // Создать карту width x height тайлов из levelCount уровней, заполненных тайлом fill
+    // (заполнитель задаётся явно: тайл 0 - земля с травой, а не воздух; заполнители уровней меняет setLevelFill)
+    ZLevelMap(int width, int height, int levelCount, TileId fill);
+
+    // Получить ширину карты в тайлах
+    int getWidth() const { return m_width; }
+    // Получить высоту карты в тайлах (по оси y уровня)
+    int getHeight() const { return m_height; }
+    // Получить количество уровней
+    int getLevelCount() const { return static_cast<int>(m_levels.size()); }
+    // Получить количество чанков уровня по горизонтали
+    int getChunkCountX() const { return (m_width + ChunkSize - 1) / ChunkSize; }
+    // Получить количество чанков уровня по вертикали
+    int getChunkCountY() const { return (m_height + ChunkSize - 1) / ChunkSize; }
+    // Проверить, что координаты лежат внутри карты
+    bool contains(int x, int y, int z) const
+    {
+        return x >= 0 && y >= 0 && z >= 0 && x < m_width && y < m_height && z < getLevelCount();
+    }
+
+    // Получить заполнитель уровня (тайл всех невыделенных чанков)
+    TileId getLevelFill(int z) const;
+    // Заменить заполнитель уровня (меняет все тайлы уровня вне выделенных чанков)
+    void setLevelFill(int z, TileId fill);
+
+    // Получить тайл (исключение, если координаты вне карты)
+    TileId getTile(int x, int y, int z) const;
+    // Изменить тайл (исключение, если координаты вне карты); чанк выделяется при первом отличии от заполнителя
+    void setTile(int x, int y, int z, TileId tile);
+    // Получить выделенный чанк уровня или nullptr, если весь чанк - заполнитель уровня
+    const PackedChunk* findChunk(int chunkX, int chunkY, int z) const;
+    // Получить размер чанка в тайлах (у правых и нижних чанков он меньше ChunkSize)
+    int getChunkWidth(int chunkX) const { return clampToChunk(m_width - chunkX * ChunkSize); }
+    int getChunkHeight(int chunkY) const { return clampToChunk(m_height - chunkY * ChunkSize); }
+
+    // Переупаковать чанки (палитры без исчезнувших типов) и освободить чанки, ставшие заполнителем уровня
+    void compact();
+    // Получить количество выделенных чанков на всех уровнях
+    std::size_t getAllocatedChunkCount() const;
+    // Получить память, занятую уровнями и чанками
+    std::size_t getMemoryBytes() const;
+
+private:
+    // Уровень: заполнитель и чанки, которые от него отличаются
+    struct Level
+    {
+        TileId fill;
+        std::unordered_map<std::uint64_t, PackedChunk> chunks; // Чанки по ключу World::chunkKey
+    };
+
+    // Проверить координаты и бросить исключение, если они вне карты
+    void check(int x, int y, int z) const;
+    // Ограничить остаток карты размером чанка
+    static int clampToChunk(int size) { return size < ChunkSize ? size : ChunkSize; }
+
+    int m_width;                 // Ширина карты в тайлах
+    int m_height;                // Высота карты в тайлах
+    std::vector<Level> m_levels; // Уровни снизу вверх
+};
@@ -1,387 +1,255 @@
 #include <SFML/Graphics.hpp>
-#include <map>
 #include <cmath>
 #include <random>
 #include <fstream>
 #include <iostream>
 
-double fade(double t) { return t * t * t * (t * (t * 6 - 15) + 10); }
-double lerp(double t, double a, double b) { return a + t * (b - a); }
-double grad(int hash, double x, double y)
-{
-    int h = hash & 15;
-    double u = h < 8 ? x : y,
-        v = h < 4 ? y : h == 12 || h == 14 ? x
-        : 0;
-    return ((h & 1) == 0 ? u : -u) + ((h & 2) == 0 ? v : -v);
-}
-
-double perlinNoise(double x, double y, int octaves, double persistence, double scale)
-{
-    double total = 0;
-    double frequency = scale;
-    double amplitude = 1;
-    double maxValue = 0;
-
-    for (int i = 0; i < octaves; i++)
-    {
-        int xi = static_cast<int>(floor(x / frequency));
-        int yi = static_cast<int>(floor(y / frequency));
-
-        double value = lerp(lerp(fade(x / frequency - xi),
-            grad(xi, x - xi, y - yi),
-            grad(xi + 1, x - xi - 1, y - yi)),
-            lerp(fade(y / frequency - yi),
-                grad(xi, x - xi, y - yi - 1),
-                grad(xi + 1, x - xi - 1, y - yi - 1)),
-            fade(y / frequency - yi));
-
-        total += value * amplitude;
-        maxValue += amplitude;
-
-        amplitude *= persistence;
-        frequency *= 2;
-    }
-
-    return total / maxValue;
-}
-
-/**
- * Generates a height map using Perlin noise algorithm.
- *
- * @param width the width of the height map
- * @param height the height of the height map
- * @param scale the scale of the noise
- * @param numOctaves the number of octaves for noise generation
- * @param persistence the persistence value for noise generation
- * @param offsetX the offset on the x-axis
- * @param offsetY the offset on the y-axis
- *
- * @return a vector of integers representing the generated height map
- *
- * @throws None
- */
-std::vector<int> generateHeightMap(int width, int height, double scale, int numOctaves, double persistence, double offsetX, double offsetY)
-{
-    std::vector<int> heightMap(width);
-
-    for (int i = 0; i < width; i++)
-    {
-        double noiseValue = perlinNoise((i + offsetX) / static_cast<double>(width), (offsetY) / static_cast<double>(width), numOctaves, persistence, scale);
-        heightMap[i] = static_cast<int>((noiseValue + 1) * 0.5 * height);
-    }
-
-    return heightMap;
-}
-
-std::vector<std::vector<int>> generateTerrain(int width, int height, int seed, std::vector<int> heightMap)
-{
-    std::vector<std::vector<int>> tileMap(height, std::vector<int>(width));
-    for (int y = 0; y < height; ++y)
-    {
-        for (int x = 0; x < width; ++x)
-        {
-            //       
-            if (y < heightMap[x])
-            {
-                tileMap[y][x] = 1; // 
-            }
-            else if (y == heightMap[x] || y == heightMap[x] + 1)
-            {
-                tileMap[y][x] = 0; //   
-            }
-            else
-            {
-                tileMap[y][x] = 2; // 
-            }
-        }
-    }
-    return tileMap;
-}
-
-int calculatePercentage(int value, int start, int end, int startPercent, int endPercent)
-{
-    if (value < start || value > end)
-    {
-        return 0;
-    }
-
-    int range = end - start;
-    int difference = endPercent - startPercent;
-    int step = difference / range;
-
-    return startPercent + (value - start) * step;
-}
-
-void generateUndergroundResources(std::vector<std::vector<int>>& tileMap, int NumTilesX, int NumTilesY)
-{
-
-    std::vector<std::pair<int, std::pair<double, double>>> resources =
-    {
-        {2, {0.0, 25.0}},   // 
-        {3, {17.5, 35.0}},  // 
-        {4, {30.0, 80.0}},  // 
-        {5, {50.0, 75.0}},  // 
-        {6, {65.0, 100.0}}, // 
-        {7, {75.0, 100.0}}  // 
-    };
-
-    std::vector<std::pair<double, double>> resourceChances =
-    {
-        {15.0, 1.8}, // 
-        {15.0, 2.0}, // 
-        {10.0, 1.2}, // 
-        {10.0, 1.6}, // 
-        {5.0, 0.71}, // 
-        {7.0, 1.32}  // 
-    };
-
-    //   
-    for (size_t i = 0; i < resources.size(); ++i)
-    {
-        double startHeightPercent = resources[i].second.first;
-        double endHeightPercent = resources[i].second.second;
-        double startChance = resourceChances[i].first;
-        double chanceStep = resourceChances[i].second;
-
-        //   y
-        for (size_t y = (int)NumTilesY * 0.3; y < NumTilesY; ++y)
-        {
-            double heightPercent = static_cast<double>(y) / static_cast<double>(NumTilesY);
-
-            if (heightPercent >= startHeightPercent / 100.0 && heightPercent <= endHeightPercent / 100.0)
-            {
-                double currentChance = startChance;
-                for (size_t x = 0; x < NumTilesX; ++x)
-                {
-                    if (static_cast<double>(rand()) / RAND_MAX < currentChance / 100.0)
-                    {
-                        if (tileMap[y][x] == 2) // 
-                        {
-                            tileMap[y][x] = resources[i].first; //   
-                            //break;
-                        }
-                    }
-                }
-                if (startHeightPercent < endHeightPercent)
-                {
-                    double chanceFactor = (heightPercent - startHeightPercent / 100.0) / ((endHeightPercent - startHeightPercent) / 100.0);
-                    currentChance += chanceStep * chanceFactor;
-                }
-            }
-        }
-    }
-}
-
-// void generateTrees(std::vector<std::vector<int>>& terrain, const std::vector<std::vector<int>>& treeTemplates)
-// {
-//     std::default_random_engine generator;
-//     std::uniform_int_distribution<int> distribution(0, 99);
-
-//     for (size_t y = 0; y < terrain.size(); ++y)
-//     {
-//         for (size_t x = 0; x < terrain[y].size(); ++x)
-//         {
-//             if (terrain[y][x] == 2) // Ground
-//             {
-//                 if (distribution(generator) < 5) // 5% chance to generate a tree
-//                 {
-//                     bool canPlaceTree = true;
-
-//                     for (const auto& treeTemplate : treeTemplates)
-//                     {
-//                         for (size_t ty = 0; ty < treeTemplate.size(); ++ty)
-//                         {
-//                             for (size_t tx = 0; tx < treeTemplate[ty].size(); ++tx)
-//                             {
-//                                 if (treeTemplate[ty][tx] != 0 &&
-//                                     (x + tx < 0 || x + tx >= terrain[0].size() ||
-//                                      y + ty < 0 || y + ty >= terrain.size() ||
-//                                      terrain[y + ty][x + tx] != 2))
-//                                 {
-//                                     canPlaceTree = false;
-//                                     break;
-//                                 }
-//                             }
-//                             if (!canPlaceTree)
-//                             {
-//                                 break;
-//                             }
-//                         }
-//                         if (canPlaceTree)
-//                         {
-//                             for (size_t ty = 0; ty < treeTemplate.size(); ++ty)
-//                             {
-//                                 for (size_t tx = 0; tx < treeTemplate[ty].size(); ++tx)
-//                                 {
-//                                     if (treeTemplate[ty][tx] != 0)
-//                                     {
-//                                         terrain[y + ty][x + tx] = 10; // Tree
-//                                     }
-//                                 }
-//                             }
-//                             break;
-//                         }
-//                     }
-//                 }
-//             }
-//         }
-//     }
-// }
+#include "Camera.h"
+#include "ChunkRenderer.h"
+#include "ChunkStreamer.h"
+#include "GameDefinitions.h"
+#include "Resources.h"
+#include "TileGrid.h"
+#include "TileMapExporter.h"
+#include "TileMapImporter.h"
+#include "TerrainGenerator.h"
+#include "ThreadPool.h"
+#include "TileRegistry.h"
+#include "World.h"
+#include "WorldFile.h"
 
 // ------------------------------------------------------------------
 
-//     ()
-class Resources
-{
-public:
-    //    
-    sf::Texture& getTexture(const std::string& name);
-    //    
-    void loadTexture(const std::string& name, const std::string& filePath);
-
-private:
-    std::map<std::string, sf::Texture> m_textures; //  
-};
-
-//    
-sf::Texture& Resources::getTexture(const std::string& name)
-{
-    return m_textures.at(name);
-}
-
-//    
-void Resources::loadTexture(const std::string& name, const std::string& filePath)
-{
-    sf::Texture texture;
-    if (!texture.loadFromFile(filePath))
-    {
-        throw std::runtime_error("Failed to load texture: " + filePath);
-    }
-    m_textures[name] = texture;
-}
-
-//     ()
+// Класс для представления тайла (плитки)
 class Tile
 {
 public:
-    //        
-    Tile(const sf::Texture& texture, int tileSize);
-    //       
+    // Создать тайл из области текстуры
+    Tile(const sf::Texture& texture, const sf::IntRect& textureRect);
+    // Нарисовать тайл на экране в указанной позиции
     void draw(sf::RenderTarget& target, sf::Vector2f position);
 
 private:
-    sf::Sprite m_sprite; //  (  )
-    int m_tileSize;      //  
+    sf::Sprite m_sprite; // Спрайт (графическое представление тайла)
+    int m_tileSize;      // Размер тайла
 };
 
-//        
-Tile::Tile(const sf::Texture& texture, int tileSize) : m_tileSize(tileSize)
+// Создать тайл из области текстуры
+Tile::Tile(const sf::Texture& texture, const sf::IntRect& textureRect) : m_tileSize(textureRect.width)
 {
     m_sprite.setTexture(texture);
-    m_sprite.setTextureRect(sf::IntRect(0, 0, tileSize, tileSize));
+    m_sprite.setTextureRect(textureRect);
 }
 
-//       
+// Нарисовать тайл на экране в указанной позиции
 void Tile::draw(sf::RenderTarget& target, sf::Vector2f position)
 {
     m_sprite.setPosition(position);
     target.draw(m_sprite);
 }
 
-int main()
+int main(int argc, char* argv[])
 {
-    //   
+    // Разобрать командную строку:
+    //   --export <файл> - куда выгрузить карту текстом;
+    //   --save <файл>   - сохранить сгенерированный мир в двоичный файл (первые экраны мира);
+    //   --load <файл>   - открыть двоичный файл мира вместо генерации;
+    //   --import <файл> - прочитать карту из текстовой выгрузки вместо генерации;
+    //   --seed <число>  - зерно генерируемого мира (по умолчанию - текущее время);
+    //   --chunk-store <файл> - хранилище изменённых чанков генерируемого мира (открывается с тем же зерном);
+    //   --chunk-memory <МиБ> - память под чанки генерируемого мира (0 - без ограничения);
+    //   --definitions <файл> - определения тайлов и руд
+    std::string exportPath;
+    std::string savePath;
+    std::string loadPath;
+    std::string importPath;
+    std::string chunkStorePath;
+    std::uint64_t worldSeed = static_cast<std::uint64_t>(time(NULL));
+    std::size_t chunkMemoryMiB = 256;
+    std::string definitionsPath = "resources/definitions.txt";
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if (argument == "--export" && i + 1 < argc)
+        {
+            exportPath = argv[++i];
+        }
+        else if (argument == "--save" && i + 1 < argc)
+        {
+            savePath = argv[++i];
+        }
+        else if (argument == "--load" && i + 1 < argc)
+        {
+            loadPath = argv[++i];
+        }
+        else if (argument == "--import" && i + 1 < argc)
+        {
+            importPath = argv[++i];
+        }
+        else if (argument == "--seed" && i + 1 < argc)
+        {
+            worldSeed = static_cast<std::uint64_t>(std::stoull(argv[++i]));
+        }
+        else if (argument == "--chunk-store" && i + 1 < argc)
+        {
+            chunkStorePath = argv[++i];
+        }
+        else if (argument == "--chunk-memory" && i + 1 < argc)
+        {
+            chunkMemoryMiB = static_cast<std::size_t>(std::stoul(argv[++i]));
+        }
+        else if (argument == "--definitions" && i + 1 < argc)
+        {
+            definitionsPath = argv[++i];
+        }
+        else
+        {
+            std::cerr << "Unknown argument: " << argument << std::endl;
+            std::cerr << "Usage: " << argv[0] << " [--export <file>] [--save <file>] [--load <file> | --import <file>]"
+                << " [--seed <number>] [--chunk-store <file>] [--chunk-memory <MiB>] [--definitions <file>]" << std::endl;
+            return 1;
+        }
+    }
+    if (!loadPath.empty() && !importPath.empty())
+    {
+        std::cerr << "--load and --import cannot be used together" << std::endl;
+        return 1;
+    }
+
+    // Получить разрешение экрана
     sf::VideoMode desktopMode = sf::VideoMode::getDesktopMode();
     int screenWidth = desktopMode.width;
     int screenHeight = desktopMode.height;
 
-    //      
+    // Создать окно приложения на весь экран
     sf::RenderWindow window(sf::VideoMode(screenWidth, screenHeight), "SFML Application");
 
-    //      
+    int tileSize = 16; // Размер тайла
+
+    // Определения тайлов и руд читаются из файла, чтобы настраивать их без пересборки
+    GameDefinitions definitions(definitionsPath);
+
+    // Зарегистрировать типы тайлов (индексы выдаются по порядку определений) и упаковать их текстуры в атлас
+    TileRegistry tileRegistry;
     Resources resources;
-    resources.loadTexture("ground_with_grass", "textures/ground_with_grass.png");
-    resources.loadTexture("sky", "textures/sky.png");
-    resources.loadTexture("rock", "textures/rock.png");
-    resources.loadTexture("tin", "textures/tin.png");
-    resources.loadTexture("Iron", "textures/Iron.png");
-    resources.loadTexture("mithril", "textures/mithril.png");
-    resources.loadTexture("silver", "textures/silver.png");
-    resources.loadTexture("gold", "textures/gold.png");
-    resources.loadTexture("copper", "textures/copper.png");
-    resources.loadTexture("wood_tree", "textures/wood_tree.png");
-    resources.loadTexture("leaves", "textures/leaves.png");
-    resources.loadTexture("grass", "textures/grass.jpg");
-
-    int tileSize = 16; //  
-
-    //     
-    Tile groundWithGrassTile(resources.getTexture("ground_with_grass"), tileSize);
-    Tile skyTile(resources.getTexture("sky"), tileSize);
-    Tile rockTile(resources.getTexture("rock"), tileSize);
-    Tile copperTile(resources.getTexture("copper"), tileSize);
-    Tile ironTile(resources.getTexture("Iron"), tileSize);
-    Tile tinTile(resources.getTexture("tin"), tileSize);
-    Tile silverTile(resources.getTexture("silver"), tileSize);
-    Tile goldTile(resources.getTexture("gold"), tileSize);
-    Tile mithrilTile(resources.getTexture("mithril"), tileSize);
-    Tile woodTreeTile(resources.getTexture("wood_tree"), tileSize);
-    Tile leavesTile(resources.getTexture("leaves"), tileSize);
-    Tile grassTile(resources.getTexture("grass"), tileSize);
-
-    //   ,   -  ,  -   
-    std::map<int, Tile*> tileDictionary;
-
-    tileDictionary[0] = &groundWithGrassTile; //   
-    tileDictionary[1] = &skyTile;             // 
-    tileDictionary[2] = &rockTile;            // 
-    tileDictionary[3] = &tinTile;             // 
-    tileDictionary[4] = &copperTile;          // 
-    tileDictionary[5] = &ironTile;            // 
-    tileDictionary[6] = &silverTile;          // 
-    tileDictionary[7] = &goldTile;            // 
-    tileDictionary[8] = &mithrilTile;         // 
-    tileDictionary[9] = &woodTreeTile;        // 
-    tileDictionary[10] = &leavesTile;         // 
-    tileDictionary[11] = &grassTile;          // 
-
-    //           
-    //           
-    int numTilesX = screenWidth / tileSize;
+    for (const TileDefinition& definition : definitions.getTiles())
+    {
+        TileId id = tileRegistry.registerType(definition.name, definition.flags);
+        resources.loadAtlasImage(id, definition.texturePath);
+    }
+    resources.buildAtlas(tileSize);
+
+    // Создать тайлы для каждого типа (индекс в векторе совпадает с индексом типа)
+    std::vector<Tile> tiles;
+    for (int id = 0; id < tileRegistry.getCount(); ++id)
+    {
+        const AtlasRegion& region = resources.getAtlasRegion(id);
+        const sf::Texture& texture = resources.getAtlasTexture(region.page);
+        tileRegistry.setTexture(static_cast<TileId>(id), texture, region.rect);
+        tiles.push_back(Tile(texture, region.rect));
+    }
+
+    // Рассчитать количество тайлов по горизонтали и вертикали: карта в высоту занимает экран,
+    // а в ширину - несколько экранов (у генерируемого мира ширины нет, это размер выгрузки)
+    int worldScreensX = 4;
+    int numTilesX = screenWidth / tileSize * worldScreensX;
     int numTilesY = screenHeight / tileSize;
 
-    std::cout << numTilesX << " " << numTilesY << std::endl;
-    srand(time(NULL));
+    TileGrid tileMap;
+    std::unique_ptr<WorldFile> worldFile; // Открытый файл мира: чанки читаются, когда попадают в камеру
+    std::unique_ptr<World> world;         // Генерируемый мир без ограничения по ширине
+    if (!loadPath.empty())
+    {
+        sf::Clock loadClock;
+        worldFile.reset(new WorldFile(loadPath, tileRegistry));
+        worldSeed = worldFile->getSeed();
+        numTilesX = worldFile->getWidth();
+        numTilesY = worldFile->getHeight();
+        tileMap = TileGrid(numTilesX, numTilesY, tileRegistry.getId("sky"));
+        std::cout << "World " << loadPath << " opened in " << loadClock.getElapsedTime().asMilliseconds() << " ms" << std::endl;
+    }
+    else if (!importPath.empty())
+    {
+        // Зерно текстовая выгрузка не хранит
+        worldSeed = 0;
+        sf::Clock importClock;
+        TileMapImporter importer;
+        tileMap = importer.importText(importPath, tileRegistry);
+        numTilesX = tileMap.getWidth();
+        numTilesY = tileMap.getHeight();
+        std::cout << "Map " << importPath << " imported in " << importClock.getElapsedTime().asMilliseconds() << " ms" << std::endl;
+    }
+    else
+    {
+        // Мир генерируется чанками, когда они впервые нужны камере; всё случайное в мире
+        // выводится из одного зерна: с тем же зерном (--seed) получится тот же мир
+        std::cout << "World seed: " << worldSeed << std::endl;
 
-    int seed = rand();
-    int offsetX = rand() % numTilesX;
-    int offsetY = rand() % numTilesY;
-    std::vector<int> heightMap = generateHeightMap(numTilesX, numTilesY, 0.01, 28, 4, offsetX, offsetY);
+        // Жилы (ResourcePlacement::Veins) в чанках пока дороже выборки с пропусками из-за запаса
+        // кандидатов вокруг каждого чанка, поэтому руды размещаются выборкой
+        world.reset(new World(worldSeed, numTilesY, definitions.getResources(), ResourcePlacement::SkipSampling));
 
-    //    (   )
-    std::vector<std::vector<int>> tileMap = generateTerrain(numTilesX, numTilesY, seed, heightMap);
+        // Память под чанки ограничена: дальние чанки вытесняются, изменённые - в хранилище
+        world->setMemoryBudget(chunkMemoryMiB * 1024 * 1024);
+        if (!chunkStorePath.empty())
+            world->openChunkStore(chunkStorePath);
 
-    //     
-    generateUndergroundResources(tileMap, numTilesX, numTilesY);
+        // Для выгрузки и сохранения берутся первые numTilesX столбцов мира, их чанки генерируются сразу на всех ядрах
+        if (!exportPath.empty() || !savePath.empty())
+        {
+            ThreadPool threadPool;
+            sf::Clock generationClock;
+            tileMap = world->copyRegion(sf::IntRect(0, 0, numTilesX, numTilesY), &threadPool);
+            tileRegistry.validate(tileMap);
+            std::cout << "World generated in " << generationClock.getElapsedTime().asMilliseconds()
+                << " ms on " << threadPool.getThreadCount() << " threads" << std::endl;
+        }
+    }
+    std::cout << numTilesX << " " << numTilesY << std::endl;
 
-    //      
-    // std::vector<std::vector<int>> treeTemplates = createTreeTemplates();
+    // Выгрузить карту в текстовый файл (мир из файла для этого читается целиком)
+    if (!exportPath.empty())
+    {
+        sf::Clock exportClock;
+        if (worldFile)
+            worldFile->loadAll(tileMap);
+        TileMapExporter exporter;
+        exporter.exportText(tileMap, exportPath);
+        std::cout << "Map exported to " << exportPath << " in " << exportClock.getElapsedTime().asMilliseconds() << " ms" << std::endl;
+    }
 
-    //     
-    // generateTrees(tileMap, treeTemplates);
+    // Сохранить сгенерированный мир в двоичный файл
+    if (!savePath.empty())
+    {
+        sf::Clock saveClock;
+        if (worldFile)
+            worldFile->loadAll(tileMap);
+        saveWorldFile(savePath, tileMap, worldSeed, tileRegistry);
+        std::cout << "World saved to " << savePath << " in " << saveClock.getElapsedTime().asMilliseconds() << " ms" << std::endl;
+    }
 
-    std::ofstream file("output.txt");
-    for (const auto& row : tileMap)
+    // Создать рендерер чанков и камеру
+    ChunkRenderer chunkRenderer(tileSize, tileRegistry);
+    Camera camera(sf::Vector2f(static_cast<float>(screenWidth), static_cast<float>(screenHeight)),
+        world ? Camera::UnboundedWidth : numTilesX, numTilesY, tileSize);
+    sf::Clock frameClock;
+
+    // Чанки мира генерируются в фоне; видимые при запуске - сразу, чтобы первый кадр не был пустым
+    std::unique_ptr<ChunkStreamer> chunkStreamer;
+    if (world)
     {
-        for (const auto& tileId : row)
-        {
-            file << tileId << " ";
-        }
-        file << std::endl;
+        world->generateChunks(camera.getVisibleTiles());
+        chunkStreamer.reset(new ChunkStreamer(*world));
     }
 
-    //   
+    // Режим отрисовки (F1 - переключить между чанками и отдельными спрайтами) и замер времени кадра
+    bool useChunkRenderer = true;
+    sf::Clock statsClock;
+    sf::Time drawTime;
+    int frameCount = 0;
+    int drawCalls = 0;
+
+    // Главный цикл приложения
     while (window.isOpen())
     {
         sf::Event event;
@@ -389,23 +257,105 @@ int main()
         {
             if (event.type == sf::Event::Closed)
                 window.close();
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F1)
+            {
+                useChunkRenderer = !useChunkRenderer;
+                statsClock.restart();
+                drawTime = sf::Time::Zero;
+                frameCount = 0;
+            }
+            camera.handleEvent(event, window);
         }
+        sf::Time frameTime = frameClock.restart();
+        camera.update(frameTime);
 
         window.clear();
+        window.setView(camera.getView());
+
+        // Нарисовать видимую часть карты тайлов
+        sf::Clock drawClock;
+        sf::IntRect visibleTiles = camera.getVisibleTiles();
 
-        //   
-        for (size_t y = 0; y < tileMap.size(); ++y)
+        // Забрать чанки, готовые в фоне, и заказать новые впереди камеры
+        if (chunkStreamer)
         {
-            for (size_t x = 0; x < tileMap[y].size(); ++x)
+            for (const sf::IntRect& added : chunkStreamer->update(visibleTiles, frameTime))
             {
-                int tileIndex = tileMap[y][x];
-                Tile* tile = tileDictionary[tileIndex];
-                if (tile)
-                    tile->draw(window, sf::Vector2f(x * tileSize, y * tileSize));
+                chunkRenderer.invalidateRect(added);
+            }
+            for (const std::string& error : chunkStreamer->takeErrors())
+            {
+                std::cerr << "Failed to load chunk: " << error << std::endl;
             }
         }
 
+        // Прочитать из файла мира чанки, впервые попавшие в камеру
+        if (worldFile)
+        {
+            for (const sf::IntRect& loaded : worldFile->loadChunks(visibleTiles, tileMap))
+            {
+                chunkRenderer.invalidateRect(loaded);
+            }
+        }
+
+        if (useChunkRenderer)
+        {
+            if (world)
+                chunkRenderer.draw(window, *world, visibleTiles);
+            else
+                chunkRenderer.draw(window, tileMap, visibleTiles);
+            drawCalls = chunkRenderer.getDrawCalls();
+        }
+        else
+        {
+            drawCalls = 0;
+            for (int y = visibleTiles.top; y < visibleTiles.top + visibleTiles.height; ++y)
+            {
+                for (int x = visibleTiles.left; x < visibleTiles.left + visibleTiles.width; ++x)
+                {
+                    TileId tileId = 0;
+                    if (world)
+                    {
+                        if (!world->findTile(x, y, tileId))
+                            continue; // Чанк ещё генерируется
+                    }
+                    else
+                    {
+                        tileId = tileMap(x, y);
+                    }
+                    tiles[tileId].draw(window, sf::Vector2f(x * tileSize, y * tileSize));
+                    ++drawCalls;
+                }
+            }
+        }
+        drawTime += drawClock.getElapsedTime();
+        ++frameCount;
+
         window.display();
+
+        // Раз в секунду вывести среднее время отрисовки и количество вызовов draw
+        if (statsClock.getElapsedTime() >= sf::seconds(1))
+        {
+            float frameMs = statsClock.getElapsedTime().asSeconds() * 1000.f / frameCount;
+            float drawMs = drawTime.asSeconds() * 1000.f / frameCount;
+            std::string stats = std::string(useChunkRenderer ? "chunks" : "sprites")
+                + " | draw calls: " + std::to_string(drawCalls)
+                + " | draw CPU: " + std::to_string(drawMs) + " ms"
+                + " | frame: " + std::to_string(frameMs) + " ms";
+            window.setTitle("SFML Application - " + stats);
+            std::cout << stats << std::endl;
+
+            statsClock.restart();
+            drawTime = sf::Time::Zero;
+            frameCount = 0;
+        }
+    }
+
+    // Остановить фоновую генерацию и записать изменённые чанки до выхода
+    if (world)
+    {
+        chunkStreamer.reset();
+        world->flush();
     }
 
     return 0;
@@ -0,0 +1,81 @@
+#include <SFML/Graphics.hpp>
+#include <string>
+
+#include "ChunkRenderer.h"
+#include "Testing.h"
+#include "TileGrid.h"
+#include "TileRegistry.h"
+#include "ZLevelMap.h"
+
+namespace
+{
+    const int TileSize = 16; // Размер тайла при отрисовке
+
+    // Цель отрисовки без окна и OpenGL: RenderTarget ничего не рисует, если не удалось активировать цель,
+    // а ChunkRenderer всё равно считает вызовы draw - по ним видно, какие вершины построены
+    class NullRenderTarget : public sf::RenderTarget
+    {
+    public:
+        sf::Vector2u getSize() const override { return sf::Vector2u(1024, 1024); }
+        bool setActive(bool) override { return false; }
+    };
+
+    // Реестр из двух типов: Blank без текстуры (не даёт вершин) и Textured с текстурой
+    struct TestRegistry
+    {
+        TestRegistry()
+        {
+            blank = registry.registerType("blank");
+            textured = registry.registerType("textured");
+            registry.setTexture(textured, texture, sf::IntRect(0, 0, TileSize, TileSize));
+        }
+
+        sf::Texture texture;
+        TileRegistry registry;
+        TileId blank;
+        TileId textured;
+    };
+}
+
+// Чанки, построенные для одной карты, не рисуются вместо чанков другой карты с теми же координатами
+TEST_CASE(ChunkRendererRebuildsChunksForAnotherMap)
+{
+    TestRegistry types;
+    ChunkRenderer renderer(TileSize, types.registry);
+    NullRenderTarget target;
+    const sf::IntRect visible(0, 0, 64, 64);
+
+    TileGrid blankMap(64, 64, types.blank);
+    TileGrid texturedMap(64, 64, types.textured);
+    renderer.draw(target, blankMap, visible);
+    TEST_CHECK(renderer.getDrawCalls() == 0, "blank map drew " + std::to_string(renderer.getDrawCalls()) + " layers");
+
+    renderer.draw(target, texturedMap, visible);
+    TEST_CHECK(renderer.getDrawCalls() == 4, "textured map drew " + std::to_string(renderer.getDrawCalls()) + " layers instead of 4");
+
+    renderer.draw(target, blankMap, visible);
+    TEST_CHECK(renderer.getDrawCalls() == 0, "blank map after the textured one drew " + std::to_string(renderer.getDrawCalls()) + " layers");
+}
+
+// При смене уровня ZLevelMap чанки перестраиваются по новому уровню, а изменённый чанк уровня рисуется после invalidateTile
+TEST_CASE(ChunkRendererRedrawsZLevelOnLevelSwitch)
+{
+    TestRegistry types;
+    ChunkRenderer renderer(TileSize, types.registry);
+    NullRenderTarget target;
+    const sf::IntRect visible(0, 0, 64, 64);
+
+    ZLevelMap levels(64, 64, 2, types.blank);
+    levels.setLevelFill(1, types.textured);
+    renderer.draw(target, levels, 0, visible);
+    TEST_CHECK(renderer.getDrawCalls() == 0, "blank level 0 drew " + std::to_string(renderer.getDrawCalls()) + " layers");
+
+    renderer.draw(target, levels, 1, visible);
+    TEST_CHECK(renderer.getDrawCalls() == 4, "textured level 1 drew " + std::to_string(renderer.getDrawCalls()) + " layers instead of 4");
+
+    // Выделенный чанк уровня 0 рисуется, остальные чанки уровня - по заполнителю
+    levels.setTile(40, 40, 0, types.textured);
+    renderer.invalidateTile(40, 40);
+    renderer.draw(target, levels, 0, visible);
+    TEST_CHECK(renderer.getDrawCalls() == 1, "level 0 with one textured tile drew " + std::to_string(renderer.getDrawCalls()) + " layers instead of 1");
+}
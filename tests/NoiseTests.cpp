@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "NoiseEngine.h"
+#include "Testing.h"
+
+namespace
+{
+    const std::uint32_t Seed = 12345;     // Зерно шума теста
+    const double Scale = 0.01;            // Частота первой октавы (как у мира)
+    const int Octaves = 8;                // Количество октав
+    const float Persistence = 0.5f;       // Затухание октав
+    const int RowLength = 3000;           // Столбцов в строке теста
+    const std::int64_t Row = 77;          // Строка решётки
+
+    // Начала строк: около нуля, по обе стороны от него и далеко от начала координат
+    const std::int64_t Origins[] = { 0, -1234, 1000000007, -3000000000ll, 40000000000ll };
+
+    // Посчитать строку шума одним вызовом
+    std::vector<float> sampleRow(const NoiseEngine& noise, std::int64_t origin, int length)
+    {
+        std::vector<float> values(length);
+        noise.fbm2DRow(origin, Row, Scale, values.data(), length, Octaves, Persistence);
+        return values;
+    }
+}
+
+// Значение столбца не зависит от уровня векторных инструкций и от того, с какого столбца начат пакет
+TEST_CASE(FbmRowDoesNotDependOnBatchOrSimdLevel)
+{
+    NoiseEngine noise(Seed);
+    NoiseEngine scalar(Seed);
+    NoiseEngine sse(Seed);
+    scalar.setSimdLevel(SimdLevel::Scalar);
+    sse.setSimdLevel(SimdLevel::Sse41);
+
+    for (std::int64_t origin : Origins)
+    {
+        std::vector<float> expected = sampleRow(scalar, origin, RowLength);
+        TEST_CHECK(sampleRow(sse, origin, RowLength) == expected, "SSE4.1 row differs from scalar at origin " + std::to_string(origin));
+        TEST_CHECK(sampleRow(noise, origin, RowLength) == expected, "SIMD row differs from scalar at origin " + std::to_string(origin));
+
+        // Пакеты разной длины, не выровненные ни по блокам, ни по ширине вектора
+        std::vector<float> pieces(RowLength);
+        int done = 0;
+        for (int length = 1; done < RowLength; length = length * 3 + 1)
+        {
+            int count = std::min(length, RowLength - done);
+            noise.fbm2DRow(origin + done, Row, Scale, pieces.data() + done, count, Octaves, Persistence);
+            done += count;
+        }
+        TEST_CHECK(pieces == expected, "batched row differs from one pass at origin " + std::to_string(origin));
+    }
+}
+
+// Строка в float совпадает с fbm2D в double и вдали от начала координат
+TEST_CASE(FbmRowMatchesDoubleNoise)
+{
+    NoiseEngine noise(Seed);
+    for (std::int64_t origin : Origins)
+    {
+        std::vector<float> values = sampleRow(noise, origin, RowLength);
+        double maxError = 0;
+        for (int i = 0; i < RowLength; ++i)
+        {
+            double expected = noise.fbm2D(static_cast<double>(origin + i) * Scale, static_cast<double>(Row) * Scale, Octaves, Persistence);
+            maxError = std::max(maxError, std::fabs(values[i] - expected));
+        }
+        TEST_CHECK(maxError < 1e-4, "float row error " + std::to_string(maxError) + " at origin " + std::to_string(origin));
+    }
+}
+
+// Решётка не повторяется с периодом 256 клеток первой октавы (25600 столбцов при частоте 0.01)
+TEST_CASE(FbmRowIsNotPeriodic)
+{
+    NoiseEngine noise(Seed);
+    std::vector<float> first = sampleRow(noise, 0, RowLength);
+    for (std::int64_t period : { 25600ll, 51200ll, 256ll * 25600ll })
+    {
+        std::vector<float> shifted = sampleRow(noise, period, RowLength);
+        double difference = 0;
+        for (int i = 0; i < RowLength; ++i)
+        {
+            difference = std::max(difference, static_cast<double>(std::fabs(first[i] - shifted[i])));
+        }
+        TEST_CHECK(difference > 0.1, "row repeats after " + std::to_string(period) + " columns");
+    }
+}
@@ -0,0 +1,89 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "OreVeins.h"
+#include "ResourceTables.h"
+#include "TerrainGenerator.h"
+#include "Testing.h"
+
+namespace
+{
+    const int RegionWidth = 256;      // Ширина участка теста
+    const int WorldHeight = 128;      // Высота мира теста
+    const int OriginX = -128;         // Первый столбец участка (участок пересекает нулевой столбец)
+    const int ChunkWidth = 16;        // Ширина кусков, на которые делится участок
+    const int ChunkHeight = 12;       // Высота кусков (не делит высоту мира, нижние куски ниже)
+    const int SkyPeriod = 7;          // Каждая SkyPeriod-я клетка участка - не камень
+    const std::uint64_t Seeds[] = { 1, 2, 3, 4, 5 };
+
+    // Руды с разными шансами, разносом и длиной жил и пересекающимися диапазонами глубин
+    std::vector<ResourceDefinition> makeResources()
+    {
+        std::vector<ResourceDefinition> resources(3);
+        resources[0].tile = 3; resources[0].top = 0.0;  resources[0].bottom = 40.0;  resources[0].chanceTop = 15.0; resources[0].chanceBottom = 15.0;
+        resources[0].veinSpacing = 10; resources[0].veinMinSize = 8;  resources[0].veinMaxSize = 20;
+        resources[1].tile = 4; resources[1].top = 30.0; resources[1].bottom = 80.0;  resources[1].chanceTop = 10.0; resources[1].chanceBottom = 10.0;
+        resources[1].veinSpacing = 8;  resources[1].veinMinSize = 12; resources[1].veinMaxSize = 28;
+        resources[2].tile = 5; resources[2].top = 70.0; resources[2].bottom = 100.0; resources[2].chanceTop = 5.0;  resources[2].chanceBottom = 5.0;
+        resources[2].veinSpacing = 20; resources[2].veinMinSize = 4;  resources[2].veinMaxSize = 12;
+        return resources;
+    }
+
+    // Участок мира: камень с вкраплениями неба
+    TileGrid makeRegion(int originX, int originY, int width, int height)
+    {
+        TileGrid region(width, height, RockTile);
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                if ((originX + x + 3 * (originY + y)) % SkyPeriod == 0)
+                    region(x, y) = SkyTile;
+            }
+        }
+        return region;
+    }
+}
+
+// Жилы зависят только от зерна и координат мира: участок, заполненный целиком, совпадает с тем же
+// участком, собранным из кусков, жилы заменяют только камень, и руды на участке есть
+TEST_CASE(VeinsDoNotDependOnRegionSplit)
+{
+    const ResourceTables tables(makeResources(), WorldHeight);
+    for (std::uint64_t seed : Seeds)
+    {
+        TileGrid whole = makeRegion(OriginX, 0, RegionWidth, WorldHeight);
+        generateOreVeins(whole, OriginX, 0, tables, seed);
+
+        int ores = 0;
+        for (int y = 0; y < WorldHeight; ++y)
+        {
+            for (int x = 0; x < RegionWidth; ++x)
+            {
+                bool rock = (OriginX + x + 3 * y) % SkyPeriod != 0;
+                TEST_CHECK(rock || whole(x, y) == SkyTile, "Vein replaced a non-rock tile at " + std::to_string(x) + ", " + std::to_string(y));
+                ores += rock && whole(x, y) != RockTile;
+            }
+        }
+        TEST_CHECK(ores > 0, "No veins placed for seed " + std::to_string(seed));
+
+        for (int chunkY = 0; chunkY < WorldHeight; chunkY += ChunkHeight)
+        {
+            for (int chunkX = 0; chunkX < RegionWidth; chunkX += ChunkWidth)
+            {
+                int height = WorldHeight - chunkY < ChunkHeight ? WorldHeight - chunkY : ChunkHeight;
+                TileGrid chunk = makeRegion(OriginX + chunkX, chunkY, ChunkWidth, height);
+                generateOreVeins(chunk, OriginX + chunkX, chunkY, tables, seed);
+                for (int y = 0; y < height; ++y)
+                {
+                    for (int x = 0; x < ChunkWidth; ++x)
+                    {
+                        TEST_CHECK(chunk(x, y) == whole(chunkX + x, chunkY + y), "Chunk differs from the whole region at "
+                            + std::to_string(chunkX + x) + ", " + std::to_string(chunkY + y) + " for seed " + std::to_string(seed));
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,231 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "HierarchicalPathfinder.h"
+#include "JumpPointSearch.h"
+#include "PathGrid.h"
+#include "Random.h"
+#include "Testing.h"
+
+namespace
+{
+    const int Width = 150;           // Ширина карты теста (не кратна размеру кластера)
+    const int Height = 100;          // Высота карты теста
+    const int QueryCount = 300;      // Запросов на каждую проверку
+    const int QueriesPerGoal = 8;    // Запросов подряд к одной цели (сохранённые расстояния от цели)
+    const int NearGoalRange = 12;    // Наибольшее смещение цели короткого запроса по каждой оси
+    const int EditRounds = 4;        // Серий изменений карты
+    const int EditsPerRound = 200;   // Изменённых клеток в серии
+    const double Tolerance = 1e-3;   // Допустимая относительная погрешность длины пути
+    const double DiagonalCost = std::sqrt(2.0);
+
+    // Получить длину пути из ходов в 8 сторон
+    double pathLength(const std::vector<sf::Vector2i>& path)
+    {
+        double length = 0;
+        for (std::size_t i = 1; i < path.size(); ++i)
+        {
+            bool diagonal = path[i].x != path[i - 1].x && path[i].y != path[i - 1].y;
+            length += diagonal ? DiagonalCost : 1.0;
+        }
+        return length;
+    }
+
+    // Проверить, что path ведёт из start в goal по проходимым клеткам ходами в 8 сторон
+    // (по диагонали - только если обе соседние по сторонам клетки проходимы)
+    std::string checkPath(const PathGrid& grid, sf::Vector2i start, sf::Vector2i goal, const std::vector<sf::Vector2i>& path)
+    {
+        if (path.empty() || path.front() != start || path.back() != goal)
+            return "path does not connect start and goal";
+        for (std::size_t i = 0; i < path.size(); ++i)
+        {
+            if (!grid.isPassable(path[i].x, path[i].y))
+                return "path cell " + std::to_string(i) + " is blocked";
+            if (i == 0)
+                continue;
+            int dx = path[i].x - path[i - 1].x;
+            int dy = path[i].y - path[i - 1].y;
+            if (std::abs(dx) > 1 || std::abs(dy) > 1 || (dx == 0 && dy == 0))
+                return "path step " + std::to_string(i) + " is not a move";
+            if (dx != 0 && dy != 0 && (!grid.isPassable(path[i - 1].x + dx, path[i - 1].y) || !grid.isPassable(path[i - 1].x, path[i - 1].y + dy)))
+                return "path step " + std::to_string(i) + " cuts a corner";
+        }
+        return std::string();
+    }
+
+    // Найти длину кратчайшего пути обычным поиском по клеткам (бесконечность, если пути нет)
+    double referenceLength(const PathGrid& grid, sf::Vector2i start, sf::Vector2i goal)
+    {
+        const double Infinity = std::numeric_limits<double>::infinity();
+        if (!grid.isPassable(start.x, start.y) || !grid.isPassable(goal.x, goal.y))
+            return Infinity;
+
+        std::vector<double> cost(static_cast<std::size_t>(grid.getWidth()) * grid.getHeight(), Infinity);
+        typedef std::pair<double, int> Entry;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+        cost[start.y * grid.getWidth() + start.x] = 0;
+        open.push(Entry(0.0, start.y * grid.getWidth() + start.x));
+        while (!open.empty())
+        {
+            Entry entry = open.top();
+            open.pop();
+            int x = entry.second % grid.getWidth();
+            int y = entry.second / grid.getWidth();
+            if (entry.first > cost[entry.second])
+                continue;
+            if (x == goal.x && y == goal.y)
+                return entry.first;
+            for (int dy = -1; dy <= 1; ++dy)
+            {
+                for (int dx = -1; dx <= 1; ++dx)
+                {
+                    if ((dx == 0 && dy == 0) || !grid.isPassable(x + dx, y + dy))
+                        continue;
+                    if (dx != 0 && dy != 0 && (!grid.isPassable(x + dx, y) || !grid.isPassable(x, y + dy)))
+                        continue;
+                    double next = entry.first + (dx != 0 && dy != 0 ? DiagonalCost : 1.0);
+                    int cell = (y + dy) * grid.getWidth() + x + dx;
+                    if (next < cost[cell])
+                    {
+                        cost[cell] = next;
+                        open.push(Entry(next, cell));
+                    }
+                }
+            }
+        }
+        return Infinity;
+    }
+
+    // Построить карту: слева открытое место, правее препятствий всё больше (отдельные области и тупики)
+    PathGrid makeGrid(RandomStream& random)
+    {
+        PathGrid grid(Width, Height);
+        for (int y = 0; y < Height; ++y)
+        {
+            for (int x = 0; x < Width; ++x)
+            {
+                double density = 0.45 * x / Width;
+                grid.setPassable(x, y, random.nextDouble() >= density);
+            }
+        }
+        return grid;
+    }
+
+    // Выбрать случайную проходимую клетку
+    sf::Vector2i randomOpenCell(const PathGrid& grid, RandomStream& random)
+    {
+        for (;;)
+        {
+            sf::Vector2i cell(static_cast<int>(random.nextBelow(Width)), static_cast<int>(random.nextBelow(Height)));
+            if (grid.isPassable(cell.x, cell.y))
+                return cell;
+        }
+    }
+
+    // Выбрать случайную проходимую клетку не дальше NearGoalRange по каждой оси от cell (или любую, если рядом их нет)
+    sf::Vector2i randomNearCell(const PathGrid& grid, sf::Vector2i cell, RandomStream& random)
+    {
+        for (int attempt = 0; attempt < 100; ++attempt)
+        {
+            sf::Vector2i near(cell.x + static_cast<int>(random.nextBelow(2 * NearGoalRange + 1)) - NearGoalRange,
+                cell.y + static_cast<int>(random.nextBelow(2 * NearGoalRange + 1)) - NearGoalRange);
+            if (grid.isPassable(near.x, near.y))
+                return near;
+        }
+        return randomOpenCell(grid, random);
+    }
+
+    // Изменить проходимость случайных клеток в обеих картах
+    template <typename Pathfinder>
+    void editGrid(PathGrid& grid, Pathfinder& pathfinder, RandomStream& random)
+    {
+        for (int i = 0; i < EditsPerRound; ++i)
+        {
+            int x = static_cast<int>(random.nextBelow(Width));
+            int y = static_cast<int>(random.nextBelow(Height));
+            bool passable = !grid.isPassable(x, y);
+            grid.setPassable(x, y, passable);
+            pathfinder.setPassable(x, y, passable);
+        }
+    }
+
+    // Сравнить HPA* с обычным поиском: путь находится тогда же, когда он есть, проходим и не короче кратчайшего.
+    // Цель меняется раз в несколько запросов, и первые запросы после изменения карты идут к прежней цели
+    void compareHierarchical(const PathGrid& grid, HierarchicalPathfinder& pathfinder, RandomStream& random, sf::Vector2i& goal, const std::string& stage)
+    {
+        std::vector<sf::Vector2i> path;
+        for (int i = 0; i < QueryCount; ++i)
+        {
+            if ((i > 0 && i % QueriesPerGoal == 0) || !grid.isPassable(goal.x, goal.y))
+                goal = randomOpenCell(grid, random);
+            sf::Vector2i start = randomOpenCell(grid, random);
+            double expected = referenceLength(grid, start, goal);
+            bool found = pathfinder.findPath(start, goal, path);
+            std::string query = stage + " query " + std::to_string(i);
+            TEST_CHECK(found == (expected < std::numeric_limits<double>::infinity()), query + ": reachability differs from grid A*");
+            if (!found)
+                continue;
+            std::string error = checkPath(grid, start, goal, path);
+            TEST_CHECK(error.empty(), query + ": " + error);
+            TEST_CHECK(pathLength(path) >= expected * (1.0 - Tolerance), query + ": path shorter than the shortest one");
+        }
+    }
+
+    // Сравнить JPS с обычным поиском: путь находится тогда же, когда он есть, проходим и кратчайший.
+    // Половина запросов короткие: такие пути часто строятся без поиска
+    void compareJumpPoint(const PathGrid& grid, JumpPointSearch& pathfinder, RandomStream& random, const std::string& stage)
+    {
+        std::vector<sf::Vector2i> path;
+        for (int i = 0; i < QueryCount; ++i)
+        {
+            sf::Vector2i start = randomOpenCell(grid, random);
+            sf::Vector2i goal = i % 2 == 0 ? randomNearCell(grid, start, random) : randomOpenCell(grid, random);
+            double expected = referenceLength(grid, start, goal);
+            bool found = pathfinder.findPath(start, goal, path);
+            std::string query = stage + " query " + std::to_string(i);
+            TEST_CHECK(found == (expected < std::numeric_limits<double>::infinity()), query + ": reachability differs from grid A*");
+            if (!found)
+                continue;
+            std::string error = checkPath(grid, start, goal, path);
+            TEST_CHECK(error.empty(), query + ": " + error);
+            double length = pathLength(path);
+            TEST_CHECK(std::fabs(length - expected) <= expected * Tolerance,
+                query + ": path length " + std::to_string(length) + " instead of " + std::to_string(expected));
+        }
+    }
+}
+
+// HPA* находит путь тогда же, когда его находит обычный A*, в том числе после изменения карты
+TEST_CASE(HierarchicalPathfinderMatchesGridSearch)
+{
+    RandomStream random(2024);
+    PathGrid grid = makeGrid(random);
+    HierarchicalPathfinder pathfinder(grid);
+    sf::Vector2i goal = randomOpenCell(grid, random);
+    compareHierarchical(grid, pathfinder, random, goal, "initial");
+    for (int round = 0; round < EditRounds; ++round)
+    {
+        editGrid(grid, pathfinder, random);
+        compareHierarchical(grid, pathfinder, random, goal, "edit round " + std::to_string(round));
+    }
+}
+
+// JPS находит кратчайший путь, как обычный A*, в том числе после изменения карты
+TEST_CASE(JumpPointSearchMatchesGridSearch)
+{
+    RandomStream random(2025);
+    PathGrid grid = makeGrid(random);
+    JumpPointSearch pathfinder(grid);
+    compareJumpPoint(grid, pathfinder, random, "initial");
+    for (int round = 0; round < EditRounds; ++round)
+    {
+        editGrid(grid, pathfinder, random);
+        compareJumpPoint(grid, pathfinder, random, "edit round " + std::to_string(round));
+    }
+}
@@ -0,0 +1,182 @@
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ResourceTables.h"
+#include "TerrainGenerator.h"
+#include "Testing.h"
+
+namespace
+{
+    const int MapWidth = 2048;                       // Ширина карты теста
+    const int MapHeight = 256;                       // Высота карты теста
+    const int BandHeight = 32;                       // Высота полосы глубин, по которой сравниваются руды
+    const int BandCount = MapHeight / BandHeight;    // Полос глубин
+    const std::uint64_t Seeds[] = { 1, 2, 3, 4, 5 }; // Зёрна, по которым суммируются руды
+    const double AllowedSigmas = 4.0;                // Допуск в стандартных отклонениях счётчика руд
+    const double VeinTolerance = 0.2;                // Допуск жил относительно ожидания по шансу (наложение жил, выход за диапазон)
+    const double MinVeinExpected = 1000.0;           // Полосы с меньшим ожиданием жил не сравниваются (края диапазонов)
+
+    // Руды с шансами, меняющимися по глубине, и пересекающимися диапазонами
+    std::vector<ResourceDefinition> makeResources()
+    {
+        std::vector<ResourceDefinition> resources(4);
+        resources[0].tile = 3; resources[0].top = 0.0;  resources[0].bottom = 25.0;  resources[0].chanceTop = 20.0; resources[0].chanceBottom = 5.0;
+        resources[1].tile = 4; resources[1].top = 17.5; resources[1].bottom = 35.0;  resources[1].chanceTop = 15.0; resources[1].chanceBottom = 15.0;
+        resources[2].tile = 5; resources[2].top = 30.0; resources[2].bottom = 80.0;  resources[2].chanceTop = 5.0;  resources[2].chanceBottom = 15.0;
+        resources[3].tile = 6; resources[3].top = 65.0; resources[3].bottom = 100.0; resources[3].chanceTop = 5.0;  resources[3].chanceBottom = 10.0;
+        return resources;
+    }
+
+    // Рельеф с поверхностью разной глубины, чтобы в строках было разное число клеток камня
+    TileGrid makeTerrain()
+    {
+        std::vector<int> heightMap(MapWidth);
+        for (int x = 0; x < MapWidth; ++x)
+        {
+            heightMap[x] = MapHeight / 8 + (x * 37) % (MapHeight / 4);
+        }
+        return generateTerrain(MapWidth, MapHeight, heightMap);
+    }
+
+    // Счётчики руд: [номер руды][полоса глубин]
+    using OreCounts = std::vector<std::vector<double>>;
+
+    // Получить номер руды по тайлу (-1, если тайл - не руда)
+    int findResource(const std::vector<ResourceDefinition>& resources, TileId tile)
+    {
+        for (std::size_t i = 0; i < resources.size(); ++i)
+        {
+            if (resources[i].tile == tile)
+                return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    // Добавить к counts руды карты по полосам глубин
+    void countOres(const TileGrid& tileMap, const std::vector<ResourceDefinition>& resources, OreCounts& counts)
+    {
+        for (int y = 0; y < tileMap.getHeight(); ++y)
+        {
+            for (int x = 0; x < tileMap.getWidth(); ++x)
+            {
+                int resource = findResource(resources, tileMap(x, y));
+                if (resource >= 0)
+                    counts[resource][y / BandHeight] += 1.0;
+            }
+        }
+    }
+
+    // Ожидаемое число руд по полосам глубин на карте terrain за одно размещение: камень строки,
+    // умноженный на вероятность руды в таблице строки
+    OreCounts expectedOres(const TileGrid& terrain, const std::vector<ResourceDefinition>& resources, const ResourceTables& tables)
+    {
+        OreCounts expected(resources.size(), std::vector<double>(BandCount, 0.0));
+        for (int y = 0; y < terrain.getHeight(); ++y)
+        {
+            int rock = 0;
+            for (int x = 0; x < terrain.getWidth(); ++x)
+            {
+                rock += terrain(x, y) == RockTile;
+            }
+            const ResourceRow& row = tables.getRow(y);
+            double previous = 0.0;
+            for (int k = 0; k < row.count; ++k)
+            {
+                expected[findResource(resources, row.tiles[k])][y / BandHeight] += rock * (row.cumulative[k] - previous);
+                previous = row.cumulative[k];
+            }
+        }
+        return expected;
+    }
+
+    // Описание счётчика для сообщения о провале
+    std::string describe(std::size_t resource, int band)
+    {
+        return "resource " + std::to_string(resource) + ", rows " + std::to_string(band * BandHeight) + ".." + std::to_string((band + 1) * BandHeight - 1);
+    }
+}
+
+// Прыжки SkipSampling должны давать то же распределение руд по глубинам, что и бросок для каждой клетки:
+// на одной карте и одних зёрнах счётчики руд по полосам глубин сходятся между собой и с ожиданием по таблицам
+// в пределах AllowedSigmas стандартных отклонений (счётчики биномиальные, дисперсия не больше среднего)
+TEST_CASE(SkipSamplingMatchesPerCellDistribution)
+{
+    const std::vector<ResourceDefinition> resources = makeResources();
+    const ResourceTables tables(resources, MapHeight);
+    const TileGrid terrain = makeTerrain();
+
+    OreCounts perCell(resources.size(), std::vector<double>(BandCount, 0.0));
+    OreCounts skipSampling = perCell;
+    for (std::uint64_t seed : Seeds)
+    {
+        TileGrid tileMap = terrain;
+        generateUndergroundResources(tileMap, MapWidth, MapHeight, tables, seed, ResourcePlacement::PerCell);
+        countOres(tileMap, resources, perCell);
+
+        tileMap = terrain;
+        generateUndergroundResources(tileMap, MapWidth, MapHeight, tables, seed, ResourcePlacement::SkipSampling);
+        countOres(tileMap, resources, skipSampling);
+    }
+
+    OreCounts expected = expectedOres(terrain, resources, tables);
+    const double runs = static_cast<double>(sizeof(Seeds) / sizeof(Seeds[0]));
+    double total = 0.0;
+    for (std::size_t resource = 0; resource < resources.size(); ++resource)
+    {
+        for (int band = 0; band < BandCount; ++band)
+        {
+            double a = perCell[resource][band];
+            double b = skipSampling[resource][band];
+            double mean = expected[resource][band] * runs;
+            total += mean;
+
+            TEST_CHECK(std::abs(a - b) <= AllowedSigmas * std::sqrt(a + b) + 1.0,
+                "PerCell " + std::to_string(a) + " vs SkipSampling " + std::to_string(b) + " for " + describe(resource, band));
+            TEST_CHECK(std::abs(a - mean) <= AllowedSigmas * std::sqrt(mean) + 1.0,
+                "PerCell " + std::to_string(a) + " vs expected " + std::to_string(mean) + " for " + describe(resource, band));
+            TEST_CHECK(std::abs(b - mean) <= AllowedSigmas * std::sqrt(mean) + 1.0,
+                "SkipSampling " + std::to_string(b) + " vs expected " + std::to_string(mean) + " for " + describe(resource, band));
+        }
+    }
+    // Без заметного числа руд сравнение ничего бы не проверяло
+    TEST_CHECK(total > 10000.0, "Too few ores to compare: " + std::to_string(total));
+}
+
+// Плотность жил выводится из шанса руды: на тех же картах и зёрнах жилы дают по полосам глубин
+// столько же руды, сколько ожидается по таблицам шансов, с точностью до VeinTolerance
+TEST_CASE(VeinsFollowChanceCurve)
+{
+    std::vector<ResourceDefinition> resources = makeResources();
+    for (ResourceDefinition& resource : resources)
+    {
+        resource.veinSpacing = 4;
+        resource.veinMinSize = 6;
+        resource.veinMaxSize = 16;
+    }
+    const ResourceTables tables(resources, MapHeight);
+    const TileGrid terrain = makeTerrain();
+    const OreCounts expected = expectedOres(terrain, resources, tables);
+
+    OreCounts veins(resources.size(), std::vector<double>(BandCount, 0.0));
+    for (std::uint64_t seed : Seeds)
+    {
+        TileGrid tileMap = terrain;
+        generateUndergroundResources(tileMap, MapWidth, MapHeight, tables, seed, ResourcePlacement::Veins);
+        countOres(tileMap, resources, veins);
+    }
+
+    const double seedCount = static_cast<double>(sizeof(Seeds) / sizeof(Seeds[0]));
+    for (std::size_t r = 0; r < resources.size(); ++r)
+    {
+        for (int band = 0; band < BandCount; ++band)
+        {
+            double mean = expected[r][band] * seedCount;
+            if (mean < MinVeinExpected)
+                continue;
+            TEST_CHECK(std::fabs(veins[r][band] - mean) <= VeinTolerance * mean,
+                describe(r, band) + ": veins " + std::to_string(veins[r][band]) + ", expected " + std::to_string(mean));
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "ResourceTables.h"
+#include "Testing.h"
+
+namespace
+{
+    const int WorldHeight = 200;   // Высота мира теста
+    const double Tolerance = 1e-9; // Допустимая погрешность вероятностей
+
+    // Проверить, что описания resources отклоняются исключением std::invalid_argument
+    bool isRejected(const std::vector<ResourceDefinition>& resources)
+    {
+        try
+        {
+            ResourceTables tables(resources, WorldHeight);
+        }
+        catch (const std::invalid_argument&)
+        {
+            return true;
+        }
+        return false;
+    }
+}
+
+// Таблица строки накапливает вероятности руд по линейным кривым шанса в порядке описаний:
+// каждая следующая руда занимает только камень, оставшийся от предыдущих
+TEST_CASE(ResourceTablesFollowChanceCurves)
+{
+    std::vector<ResourceDefinition> resources(2);
+    resources[0].tile = 3; resources[0].top = 10.0; resources[0].bottom = 60.0;  resources[0].chanceTop = 20.0; resources[0].chanceBottom = 5.0;
+    resources[1].tile = 4; resources[1].top = 40.0; resources[1].bottom = 100.0; resources[1].chanceTop = 5.0;  resources[1].chanceBottom = 30.0;
+    const ResourceTables tables(resources, WorldHeight);
+    TEST_CHECK(tables.getWorldHeight() == WorldHeight, "Wrong world height");
+
+    for (int y = 0; y < WorldHeight; ++y)
+    {
+        const ResourceRow& row = tables.getRow(y);
+        const std::string at = "row " + std::to_string(y);
+        double heightPercent = 100.0 * y / WorldHeight;
+        double stoneLeft = 1.0;
+        double total = 0.0;
+        int count = 0;
+        for (const ResourceDefinition& resource : resources)
+        {
+            if (heightPercent < resource.top || heightPercent > resource.bottom)
+                continue;
+            double position = (heightPercent - resource.top) / (resource.bottom - resource.top);
+            double chance = (resource.chanceTop + (resource.chanceBottom - resource.chanceTop) * position) / 100.0;
+            total += stoneLeft * chance;
+            stoneLeft *= 1.0 - chance;
+
+            std::string tile = std::to_string(resource.tile);
+            TEST_CHECK(count < row.count && row.tiles[count] == resource.tile, at + ": resource tile " + tile + " missing");
+            TEST_CHECK(std::fabs(row.cumulative[count] - total) <= Tolerance, at + ": wrong cumulative chance of tile " + tile);
+            ++count;
+        }
+        TEST_CHECK(row.count == count, at + ": " + std::to_string(row.count) + " resources instead of " + std::to_string(count));
+        TEST_CHECK(std::fabs(row.total - total) <= Tolerance, at + ": wrong total chance");
+    }
+
+    TEST_CHECK(tables.getVeins().size() == resources.size(), "Vein parameters missing");
+    TEST_CHECK(tables.getVeins()[1].top == 80 && tables.getVeins()[1].bottom == WorldHeight, "Vein depth band not converted to rows");
+}
+
+// Неверные описания и строки, которые пересекает больше MaxRowResources руд, отклоняются
+TEST_CASE(ResourceTablesRejectInvalidDefinitions)
+{
+    std::vector<ResourceDefinition> resources(1);
+    resources[0].tile = 3;
+    resources[0].top = 50.0;
+    resources[0].bottom = 40.0;
+    TEST_CHECK(isRejected(resources), "Inverted depth range accepted");
+
+    resources[0].bottom = 60.0;
+    resources[0].veinMinSize = 5;
+    resources[0].veinMaxSize = 4;
+    TEST_CHECK(isRejected(resources), "Vein size range with min > max accepted");
+
+    resources.assign(MaxRowResources + 1, ResourceDefinition());
+    for (std::size_t i = 0; i < resources.size(); ++i)
+    {
+        resources[i].tile = static_cast<TileId>(3 + i);
+        resources[i].bottom = 100.0;
+    }
+    TEST_CHECK(isRejected(resources), "More than MaxRowResources resources in one row accepted");
+    resources.pop_back();
+    TEST_CHECK(!isRejected(resources), "MaxRowResources resources in one row rejected");
+}
@@ -0,0 +1,32 @@
+#include <exception>
+#include <iostream>
+
+#include "Testing.h"
+
+// Получить все зарегистрированные тесты в порядке регистрации
+std::vector<TestCase>& getTestCases()
+{
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+// Запустить все тесты; код возврата - 0, если все прошли
+int main()
+{
+    int failed = 0;
+    for (const TestCase& test : getTestCases())
+    {
+        try
+        {
+            test.run();
+            std::cout << "[ OK ] " << test.name << std::endl;
+        }
+        catch (const std::exception& e)
+        {
+            ++failed;
+            std::cout << "[FAIL] " << test.name << ": " << e.what() << std::endl;
+        }
+    }
+    std::cout << getTestCases().size() - failed << " passed, " << failed << " failed" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Минимальный набор для тестов без сторонних библиотек: тест - функция без параметров,
+// проваленная проверка бросает TestFailure, а TestMain запускает все зарегистрированные тесты
+struct TestFailure : std::runtime_error
+{
+    using std::runtime_error::runtime_error;
+};
+
+// Зарегистрированный тест
+struct TestCase
+{
+    const char* name; // Имя теста
+    void (*run)();    // Функция теста
+};
+
+// Получить все зарегистрированные тесты в порядке регистрации
+std::vector<TestCase>& getTestCases();
+
+// Регистрирует тест при статической инициализации (через TEST_CASE)
+struct TestRegistration
+{
+    TestRegistration(const char* name, void (*run)()) { getTestCases().push_back({ name, run }); }
+};
+
+// Проверить условие (TestFailure с файлом, строкой и сообщением, если оно ложно)
+inline void checkCondition(bool condition, const std::string& message, const char* file, int line)
+{
+    if (!condition)
+    {
+        throw TestFailure(std::string(file) + ":" + std::to_string(line) + ": " + message);
+    }
+}
+
+#define TEST_CHECK(condition, message) checkCondition((condition), (message), __FILE__, __LINE__)
+
+// Объявить и зарегистрировать тест
+#define TEST_CASE(name)                                            \
+    static void name();                                            \
+    static TestRegistration name##Registration(#name, name);       \
+    static void name()
@@ -0,0 +1,47 @@
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Testing.h"
+#include "ThreadPool.h"
+
+// Исключение из задачи не завершает процесс, доходит до поставившего задачу через future, и пул продолжает выполнять задачи
+TEST_CASE(ThrowingTaskDoesNotStopPool)
+{
+    ThreadPool pool(2);
+    std::vector<std::future<void>> results;
+    for (int i = 0; i < 8; ++i)
+    {
+        results.push_back(pool.submit([] { throw std::runtime_error("task failed"); }));
+    }
+    for (std::future<void>& result : results)
+    {
+        std::string message;
+        try
+        {
+            result.get();
+        }
+        catch (const std::runtime_error& error)
+        {
+            message = error.what();
+        }
+        TEST_CHECK(message == "task failed", "task exception was not delivered through its future");
+    }
+
+    // Задача без ошибки завершает свой future обычным образом
+    std::atomic<bool> ran(false);
+    pool.submit([&ran] { ran = true; }).get();
+    TEST_CHECK(ran, "future completed before its task ran");
+
+    std::atomic<int> sum(0);
+    pool.parallelFor(1000, 10, [&sum](int begin, int end)
+    {
+        for (int i = begin; i < end; ++i)
+        {
+            sum += i;
+        }
+    });
+    TEST_CHECK(sum == 999 * 1000 / 2, "parallelFor after throwing tasks summed " + std::to_string(sum.load()));
+}
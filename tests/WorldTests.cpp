@@ -0,0 +1,150 @@
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Testing.h"
+#include "World.h"
+
+// Запись, расширившая палитру чанка, не оставляет мир с открытым хранилищем сверх бюджета памяти,
+// а вытесненные изменённые чанки читаются из хранилища
+TEST_CASE(SetTileKeepsWorldWithinMemoryBudget)
+{
+    const std::string path = "WorldTests.tchk";
+    const int BudgetChunks = 12;
+    std::remove(path.c_str());
+    {
+        World world(7, 64, std::vector<ResourceDefinition>(), ResourcePlacement::PerCell);
+        world.openChunkStore(path);
+        // Бюджет вмещает несколько нетронутых чанков или один чанк со всеми записанными тайлами
+        for (int chunkX = 0; chunkX < BudgetChunks; ++chunkX)
+        {
+            world.getChunk(chunkX, 0);
+        }
+        world.setMemoryBudget(world.getResidentBytes());
+
+        for (int i = 0; i < 64; ++i)
+        {
+            world.setTile(i % World::ChunkSize, i / World::ChunkSize, static_cast<TileId>(100 + i));
+            TEST_CHECK(world.getResidentBytes() <= world.getMemoryBudget(),
+                "resident " + std::to_string(world.getResidentBytes()) + " bytes over budget " + std::to_string(world.getMemoryBudget()));
+        }
+        TEST_CHECK(world.getGeneratedChunkCount() < BudgetChunks, "no chunk was evicted");
+
+        for (int chunkX = 1; chunkX < 2 * BudgetChunks; ++chunkX)
+        {
+            world.getChunk(chunkX, 0);
+        }
+        for (int i = 0; i < 64; ++i)
+        {
+            TEST_CHECK(world.getTile(i % World::ChunkSize, i / World::ChunkSize) == 100 + i, "evicted tile write " + std::to_string(i) + " lost");
+        }
+    }
+    std::remove(path.c_str());
+}
+
+// Хранилище чанков открывается только миром с тем же зерном и высотой: изменения возвращаются
+// в тот же мир, а мир с другим зерном или высотой хранилище отклоняет
+TEST_CASE(ChunkStoreOpensOnlyForTheSameWorld)
+{
+    const std::string path = "WorldTests.tchk";
+    std::remove(path.c_str());
+    {
+        World world(7, 64, std::vector<ResourceDefinition>(), ResourcePlacement::PerCell);
+        world.openChunkStore(path);
+        world.setTile(5, 40, 200);
+        world.flush();
+    }
+
+    bool rejected[2] = { false, false };
+    const std::uint64_t seeds[2] = { 8, 7 };
+    const int heights[2] = { 64, 96 };
+    for (int i = 0; i < 2; ++i)
+    {
+        World other(seeds[i], heights[i], std::vector<ResourceDefinition>(), ResourcePlacement::PerCell);
+        try
+        {
+            other.openChunkStore(path);
+        }
+        catch (const std::runtime_error&)
+        {
+            rejected[i] = true;
+        }
+    }
+    TEST_CHECK(rejected[0], "chunk store opened by a world with another seed");
+    TEST_CHECK(rejected[1], "chunk store opened by a world with another height");
+
+    TileId restored;
+    {
+        World same(7, 64, std::vector<ResourceDefinition>(), ResourcePlacement::PerCell);
+        same.openChunkStore(path);
+        restored = same.getTile(5, 40);
+    }
+    std::remove(path.c_str());
+    TEST_CHECK(restored == 200, "stored tile not restored");
+}
+
+// Запись, чанк которой не совпадает по форме с чанками мира, считается повреждением журнала:
+// иначе широкий чанк переполнил бы буферы строк шириной ChunkSize при чтении
+TEST_CASE(ChunkStoreRejectsRecordsOfAnotherShape)
+{
+    const std::string path = "WorldTests.tchk";
+    const long RecordWidthOffset = 24 + 8; // Заголовок журнала, x и y первой записи
+    std::remove(path.c_str());
+    {
+        World world(7, 40, std::vector<ResourceDefinition>(), ResourcePlacement::PerCell);
+        world.openChunkStore(path);
+        world.setTile(5, 35, 200);
+        world.flush();
+    }
+
+    // Ширина и высота записи: нижний чанк мира высотой 40 - 32 x 8
+    const std::uint16_t shapes[3][2] = { { 64, 8 }, { 32, 32 }, { 32, 8 } };
+    for (int i = 0; i < 3; ++i)
+    {
+        std::FILE* file = std::fopen(path.c_str(), "r+b");
+        TEST_CHECK(file != nullptr, "chunk store not written");
+        std::fseek(file, RecordWidthOffset, SEEK_SET);
+        std::fwrite(shapes[i], sizeof(shapes[i]), 1, file);
+        std::fclose(file);
+
+        World world(7, 40, std::vector<ResourceDefinition>(), ResourcePlacement::PerCell);
+        bool rejected = false;
+        try
+        {
+            world.openChunkStore(path);
+        }
+        catch (const std::runtime_error&)
+        {
+            rejected = true;
+        }
+        std::string shape = std::to_string(shapes[i][0]) + "x" + std::to_string(shapes[i][1]);
+        TEST_CHECK(rejected == (i != 2), "chunk record " + shape + (i != 2 ? " accepted" : " rejected"));
+    }
+    std::remove(path.c_str());
+}
+
+// Без хранилища изменённые чанки не вытесняются: записи переживают обход других чанков
+// при малом бюджете, а нетронутые чанки вытесняются как обычно
+TEST_CASE(SetTileWithoutChunkStoreIsNotLost)
+{
+    World world(7, 64, std::vector<ResourceDefinition>(), ResourcePlacement::PerCell);
+    world.getChunk(0, 0);
+    world.setMemoryBudget(world.getResidentBytes());
+
+    const int WrittenChunks = 3;
+    for (int chunkX = 0; chunkX < WrittenChunks; ++chunkX)
+    {
+        world.setTile(chunkX * World::ChunkSize + 3, 40, static_cast<TileId>(200 + chunkX));
+    }
+    for (int chunkX = -20; chunkX < 20; ++chunkX)
+    {
+        world.getChunk(chunkX, 1);
+    }
+
+    for (int chunkX = 0; chunkX < WrittenChunks; ++chunkX)
+    {
+        TEST_CHECK(world.getTile(chunkX * World::ChunkSize + 3, 40) == 200 + chunkX, "tile write in chunk " + std::to_string(chunkX) + " lost");
+    }
+    TEST_CHECK(world.getGeneratedChunkCount() <= WrittenChunks + 1, "clean chunks were not evicted");
+}
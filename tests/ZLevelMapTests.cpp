@@ -0,0 +1,82 @@
+#include <stdexcept>
+#include <string>
+
+#include "TerrainGenerator.h"
+#include "Testing.h"
+#include "ZLevelMap.h"
+
+namespace
+{
+    const int Width = 80;      // Ширина карты теста (не кратна размеру чанка)
+    const int Height = 70;     // Высота карты теста (не кратна размеру чанка)
+    const int LevelCount = 4;  // Уровней в карте теста
+    const TileId OreTile = 5;  // Тайл, которым отличаются выделенные чанки
+}
+
+// Тайлы уровня без выделенных чанков - его заполнитель; запись другого тайла выделяет только его чанк,
+// запись заполнителя ничего не выделяет, а compact освобождает чанки, снова ставшие заполнителем
+TEST_CASE(ZLevelMapReadsAndWritesSharedAndAllocatedLevels)
+{
+    ZLevelMap levels(Width, Height, LevelCount, SkyTile);
+    levels.setLevelFill(0, RockTile);
+    TEST_CHECK(levels.getTile(0, 0, 0) == RockTile && levels.getTile(Width - 1, Height - 1, 0) == RockTile, "level 0 is not filled with rock");
+    TEST_CHECK(levels.getTile(40, 40, 3) == SkyTile, "level 3 is not filled with sky");
+
+    levels.setTile(10, 10, 1, SkyTile);
+    TEST_CHECK(levels.getAllocatedChunkCount() == 0, "writing the level fill allocated a chunk");
+
+    // Правый нижний чанк уровня меньше ChunkSize
+    levels.setTile(Width - 1, Height - 1, 1, OreTile);
+    levels.setTile(33, 2, 2, OreTile);
+    TEST_CHECK(levels.getAllocatedChunkCount() == 2, std::to_string(levels.getAllocatedChunkCount()) + " chunks allocated instead of 2");
+    TEST_CHECK(levels.getTile(Width - 1, Height - 1, 1) == OreTile && levels.getTile(33, 2, 2) == OreTile, "written tiles not read back");
+    TEST_CHECK(levels.getTile(Width - 2, Height - 1, 1) == SkyTile && levels.getTile(34, 2, 2) == SkyTile, "allocated chunk lost the level fill");
+    TEST_CHECK(levels.getTile(33, 2, 1) == SkyTile && levels.getTile(33, 2, 3) == SkyTile, "write leaked to another level");
+
+    const PackedChunk* chunk = levels.findChunk(Width / ZLevelMap::ChunkSize, Height / ZLevelMap::ChunkSize, 1);
+    TEST_CHECK(chunk && chunk->getWidth() == Width % ZLevelMap::ChunkSize && chunk->getHeight() == Height % ZLevelMap::ChunkSize,
+        "edge chunk does not match the map size");
+    TEST_CHECK(!levels.findChunk(0, 0, 1), "untouched chunk is allocated");
+
+    // Заполнитель меняет тайлы только вне выделенных чанков
+    levels.setLevelFill(2, RockTile);
+    TEST_CHECK(levels.getTile(0, 0, 2) == RockTile && levels.getTile(34, 2, 2) == SkyTile && levels.getTile(33, 2, 2) == OreTile,
+        "level fill changed tiles of an allocated chunk");
+
+    levels.setTile(Width - 1, Height - 1, 1, SkyTile);
+    levels.compact();
+    TEST_CHECK(levels.getAllocatedChunkCount() == 1, "compact kept a chunk that is all level fill");
+
+    bool rejected = false;
+    try
+    {
+        levels.setTile(Width, 0, 0, OreTile);
+    }
+    catch (const std::out_of_range&)
+    {
+        rejected = true;
+    }
+    TEST_CHECK(rejected, "write outside the map was accepted");
+}
+
+// Однородные уровни не занимают памяти под тайлы: память не растёт ни с размером карты, ни с заполнителями уровней,
+// а выделенный чанк добавляет только свой сжатый чанк
+TEST_CASE(ZLevelMapMemoryStaysFlatForUniformLevels)
+{
+    const int LargeSize = 32768;
+    const int ManyLevels = 256;
+    ZLevelMap small(64, 64, ManyLevels, SkyTile);
+    ZLevelMap large(LargeSize, LargeSize, ManyLevels, SkyTile);
+    for (int z = 0; z < ManyLevels / 2; ++z)
+    {
+        large.setLevelFill(z, RockTile);
+    }
+    TEST_CHECK(large.getMemoryBytes() == small.getMemoryBytes(),
+        "uniform levels take " + std::to_string(large.getMemoryBytes()) + " bytes instead of " + std::to_string(small.getMemoryBytes()));
+
+    std::size_t uniformBytes = large.getMemoryBytes();
+    large.setTile(LargeSize / 2, LargeSize / 2, ManyLevels - 1, OreTile);
+    std::size_t growth = large.getMemoryBytes() - uniformBytes;
+    TEST_CHECK(large.getAllocatedChunkCount() == 1 && growth < 1024,
+        "one changed tile added " + std::to_string(growth) + " bytes");
+}